@@ -0,0 +1,213 @@
+#ifndef BENCHMARK_SETUP_HPP
+#define BENCHMARK_SETUP_HPP
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <map>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace Tolik;
+
+// Keeps compiler from throwing away result of benchmarked code
+template<typename T>
+inline void DoNotOptimize(const T &value)
+{ asm volatile("" : : "r,m"(value) : "memory"); }
+
+// Time stamp counter, it ticks at nominal frequency of CPU, so cycles are approximate under turbo or power saving
+// 0 where there is no counter
+inline uint64_t ReadCycleCounter()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct BenchmarkResult
+{
+    std::string name;
+    double nanosecondsPerItem = 0;
+    double cyclesPerItem = 0;
+};
+
+// Every RunBenchmark call of the program in order, for ReportBenchmarks
+inline std::vector<BenchmarkResult> &GetBenchmarkResults()
+{
+    static std::vector<BenchmarkResult> results;
+    return results;
+}
+
+// Runs function repeats times and prints the best time per item
+// function must process itemCount items each time it's called
+template<typename Functor>
+inline double RunBenchmark(const std::string &name, std::size_t itemCount, Functor function, std::size_t repeats = 5)
+{
+    double bestNanoseconds = std::numeric_limits<double>::max();
+    uint64_t bestCycles = std::numeric_limits<uint64_t>::max();
+    for(std::size_t i = 0; i < repeats; i++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        const uint64_t startCycles = ReadCycleCounter();
+        function();
+        const uint64_t endCycles = ReadCycleCounter();
+        const auto end = std::chrono::steady_clock::now();
+        bestNanoseconds = std::min(bestNanoseconds, std::chrono::duration<double, std::nano>(end - start).count());
+        bestCycles = std::min(bestCycles, endCycles - startCycles);
+    }
+
+    const double nanosecondsPerItem = bestNanoseconds / itemCount;
+    const double cyclesPerItem = static_cast<double>(bestCycles) / itemCount;
+    std::cout << std::left << std::setw(56) << name << std::right
+              << std::fixed << std::setprecision(3) << std::setw(10) << nanosecondsPerItem << " ns/item"
+              << std::setprecision(1) << std::setw(10) << 1000.0 / nanosecondsPerItem << " M items/s"
+              << std::setprecision(2) << std::setw(10) << cyclesPerItem << " cycles/item\n";
+    GetBenchmarkResults().push_back({ name, nanosecondsPerItem, cyclesPerItem });
+    return nanosecondsPerItem;
+}
+
+inline std::string EscapeJson(const std::string &text)
+{
+    std::string escaped;
+    for(char c : text)
+    {
+        if(c == '"' || c == '\\')
+            escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Results written by WriteBenchmarkJson: one result per line, name and ns_per_item are read back
+inline std::map<std::string, double> ReadBenchmarkJson(std::istream &in)
+{
+    std::map<std::string, double> baseline;
+    const std::string nameKey = "\"name\": \"";
+    const std::string timeKey = "\"ns_per_item\": ";
+    for(std::string line; std::getline(in, line);)
+    {
+        const std::size_t nameStart = line.find(nameKey);
+        const std::size_t timeStart = line.find(timeKey);
+        if(nameStart == std::string::npos || timeStart == std::string::npos)
+            continue;
+        std::string name;
+        for(std::size_t i = nameStart + nameKey.size(); i < line.size() && line[i] != '"'; i++)
+            name += line[i] == '\\' && i + 1 < line.size() ? line[++i] : line[i];
+        baseline[name] = std::strtod(line.c_str() + timeStart + timeKey.size(), nullptr);
+    }
+    return baseline;
+}
+
+inline void WriteBenchmarkJson(std::ostream &out, const std::string &suite)
+{
+    out << "{\n  \"suite\": \"" << EscapeJson(suite) << "\",\n  \"results\": [\n";
+    const std::vector<BenchmarkResult> &results = GetBenchmarkResults();
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        out << std::setprecision(4) << std::defaultfloat
+            << "    { \"name\": \"" << EscapeJson(results[i].name) << "\", \"ns_per_item\": " << results[i].nanosecondsPerItem
+            << ", \"items_per_second\": " << 1e9 / results[i].nanosecondsPerItem << ", \"cycles_per_item\": " << results[i].cyclesPerItem
+            << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// Saves results of RunBenchmark calls and compares them with stored ones, to be returned from main
+// Environment variables:
+// BENCHMARK_JSON - file to write results to
+// BENCHMARK_BASELINE - results of earlier run, every benchmark that got slower by more than BENCHMARK_TOLERANCE
+// (0.1 = 10% by default) is printed, and 1 is returned
+inline int ReportBenchmarks(const std::string &suite)
+{
+    if(const char *path = std::getenv("BENCHMARK_JSON"))
+    {
+        std::ofstream out(path);
+        WriteBenchmarkJson(out, suite);
+        if(!out)
+        {
+            std::cout << "Can't write " << path << "\n";
+            return 1;
+        }
+    }
+
+    const char *baselinePath = std::getenv("BENCHMARK_BASELINE");
+    if(baselinePath == nullptr)
+        return 0;
+    std::ifstream in(baselinePath);
+    if(!in)
+    {
+        std::cout << "No baseline " << baselinePath << "\n";
+        return 0;
+    }
+    const char *toleranceText = std::getenv("BENCHMARK_TOLERANCE");
+    const double tolerance = toleranceText != nullptr ? std::strtod(toleranceText, nullptr) : 0.1;
+    const std::map<std::string, double> baseline = ReadBenchmarkJson(in);
+
+    int regressions = 0;
+    std::cout << "Compared with " << baselinePath << ":\n";
+    for(const BenchmarkResult &result : GetBenchmarkResults())
+    {
+        const auto found = baseline.find(result.name);
+        if(found == baseline.end())
+            continue;
+        const double change = result.nanosecondsPerItem / found->second - 1;
+        const bool regression = change > tolerance;
+        regressions += regression;
+        std::cout << (regression ? "REGRESSION " : "           ") << std::left << std::setw(56) << result.name << std::right
+                  << std::fixed << std::setprecision(1) << std::showpos << std::setw(8) << change * 100 << std::noshowpos << "%\n";
+    }
+    return regressions != 0;
+}
+
+// Random value using all bits of T
+template<typename T>
+inline T RandomValue(std::mt19937_64 &generator)
+{
+    if constexpr(sizeof(T) > sizeof(uint64_t))
+        return static_cast<T>((static_cast<MakeUnsignedT<T>>(generator()) << 64) | generator());
+    else
+        return static_cast<T>(generator());
+}
+
+// Values uniformly distributed over whole range of T, so most of them have maximum digit count
+template<typename T>
+inline std::vector<T> UniformValues(std::size_t count, uint64_t seed = 42)
+{
+    std::mt19937_64 generator(seed);
+    std::vector<T> values(count);
+    for(T &value : values)
+        value = RandomValue<T>(generator);
+    return values;
+}
+
+// Values with uniformly distributed digit count, so short numbers are as common as long ones
+template<typename T>
+inline std::vector<T> SkewedValues(std::size_t count, uint64_t seed = 42)
+{
+    using UnsignedT = MakeUnsignedT<T>;
+    std::mt19937_64 generator(seed);
+    std::vector<T> values(count);
+    for(T &value : values)
+    {
+        const int digits = 1 + static_cast<int>(generator() % (kMaxDigits<T> - 1));
+        UnsignedT low = 1;
+        for(int i = 1; i < digits; i++)
+            low = low * 10;
+        value = static_cast<T>(low + RandomValue<UnsignedT>(generator) % (low * 9));
+    }
+    return values;
+}
+
+#endif // BENCHMARK_SETUP_HPP
@@ -0,0 +1,382 @@
+#ifndef TOLIK_ALGORITHMS_DIGIT_DP_HPP
+#define TOLIK_ALGORITHMS_DIGIT_DP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Math/Utils.hpp"
+
+// Counting and enumeration of numbers with fixed digit count under per digit constraints
+// Generalization of DigitRange ranges from Palindromes.hpp: every position has any set of allowed digits,
+// and digit sum, remainder and palindrome symmetry can be required on top of that.
+// DigitDP counts completions for every (position, digit sum, remainder) state once, in O(digits * states * 10),
+// then count is read from the table, and enumeration never goes into subtree that has no matches
+// Example: numbers with 3 digits from {1, 3, 7}, digit sum 11 and divisible by 7
+// DigitConstraints constraints; constraints.allowedDigits = { 0b10001010, 0b10001010, 0b10001010 };
+// constraints.digitSum = 11; constraints.modulus = 7;
+// DigitDP<int>(constraints).Count() = 1 (371)
+
+namespace Tolik
+{
+struct DigitConstraints
+{
+	static constexpr DefUIntType kAnyDigitSum = std::numeric_limits<DefUIntType>::max();
+	static constexpr uint16_t kAllDigits = 0x3FF;
+
+	// Bit mask of allowed digits per position, the most significant first: bit d allows digit d
+	// Its size is digit count. The most significant digit can't be 0, unless there is only one digit
+	std::vector<uint16_t> allowedDigits;
+	// Exact sum of all digits, kAnyDigitSum means no constraint
+	DefUIntType digitSum = kAnyDigitSum;
+	// number % modulus must be remainder, modulus must not be 0
+	DefUIntType modulus = 1;
+	DefUIntType remainder = 0;
+	// Digit i must be equal to digit size - i - 1, only positions in upper half are chosen
+	bool palindrome = false;
+};
+
+// Mask of digits in [range.min, range.max)
+constexpr inline uint16_t GetDigitMask(palindrome::DigitRange range)
+{ return range.min < std::min<uint8_t>(range.max, 10) ? static_cast<uint16_t>(((1u << std::min<uint8_t>(range.max, 10)) - 1) & ~((1u << range.min) - 1)) : 0; }
+
+// Constraints that pass the same numbers as palindrome::GetPalindromesDigitRange(ranges, callback)
+inline DigitConstraints MakePalindromeConstraints(const std::vector<palindrome::DigitRange> &ranges);
+
+
+template<typename T, typename CountType>
+class DigitDP;
+
+// Forward iterator over numbers of DigitDP in ascending order
+// Next number is found by going back to the last position that can take bigger digit and filling the rest with
+// the smallest digits that still lead to a match, both looked up in the table, so empty subtrees are never visited
+// Iterators point into DigitDP, so it must outlive them
+template<typename T, typename CountType>
+class DigitDPIterator
+{
+public:
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using reference = T;
+	using pointer = void;
+	// Legacy forward iterators must return reference, so for old algorithms it is only input iterator
+	using iterator_category = std::input_iterator_tag;
+	using iterator_concept = std::forward_iterator_tag;
+
+	DigitDPIterator() {}
+	// Iterator at the first number of dp, or end iterator if there is no number
+	explicit DigitDPIterator(const DigitDP<T, CountType> *dp);
+
+	T operator*() const { return m_number; }
+
+	DigitDPIterator &operator++();
+	DigitDPIterator operator++(int) { DigitDPIterator old = *this; ++*this; return old; }
+
+	friend bool operator==(const DigitDPIterator &a, const DigitDPIterator &b)
+	{ return a.m_dp == b.m_dp && a.m_number == b.m_number; }
+	friend bool operator!=(const DigitDPIterator &a, const DigitDPIterator &b)
+	{ return !(a == b); }
+
+private:
+	// Positions from position on get the smallest digits that lead to a match, state at position must have one
+	void FillSmallest(std::size_t position);
+
+	// nullptr for end iterator
+	const DigitDP<T, CountType> *m_dp = nullptr;
+	T m_number = T(0);
+	// Digits of chosen positions, and digit sum and remainder before each position
+	std::array<uint8_t, kMaxDigits<T>> m_digits{};
+	std::array<DefUIntType, kMaxDigits<T> + 1> m_sums{};
+	std::array<DefUIntType, kMaxDigits<T> + 1> m_remainders{};
+};
+
+// Table of counts for constraints, it holds (chosen positions + 1) * (digitSum + 1) * modulus counts
+// CountType must hold count of all matches. Digit counts T can't hold give nothing, and so does the longest one
+// if its biggest match doesn't fit into T (matches that are smaller aren't passed either)
+template<typename T, typename CountType = uint64_t>
+class DigitDP
+{
+public:
+	explicit DigitDP(const DigitConstraints &constraints);
+
+	// O(1)
+	CountType Count() const { return m_positions.empty() ? CountType(0) : GetWays(0, 0, 0); }
+
+	// Calls callback(T number) for every match in ascending order
+	template<typename Functor>
+	void GetNumbers(Functor callback) const;
+
+	// Match with index in ascending order (from 0) in O(digits * 10), T(0) if index >= Count()
+	T GetNumberWithIndex(CountType index) const;
+
+	DigitDPIterator<T, CountType> begin() const { return DigitDPIterator<T, CountType>(this); }
+	DigitDPIterator<T, CountType> end() const { return DigitDPIterator<T, CountType>(); }
+
+private:
+	friend class DigitDPIterator<T, CountType>;
+
+	// Position that is chosen freely, for palindromes it also sets the mirrored one
+	struct Position
+	{
+		uint16_t mask = 0;
+		// Added to digit sum per unit of digit
+		DefUIntType sumWeight = 0;
+		// Added to remainder by every digit, already reduced, so that no division is left for enumeration
+		std::array<DefUIntType, 10> remainders{};
+		// Added to number per unit of digit
+		T place = T(0);
+	};
+
+	std::size_t GetIndex(std::size_t position, DefUIntType sum, DefUIntType remainder) const
+	{ return (position * m_sumStates + sum) * m_modulus + remainder; }
+	CountType GetWays(std::size_t position, DefUIntType sum, DefUIntType remainder) const
+	{ return m_ways[GetIndex(position, sum, remainder)]; }
+
+	// State after digit at position, false if digit sum goes past the required one
+	bool Advance(std::size_t position, uint8_t digit, DefUIntType &sum, DefUIntType &remainder) const;
+	// Is the biggest match not bigger than std::numeric_limits<T>::max(), it's built with overflow checks
+	bool BiggestFits() const;
+
+	template<typename Functor>
+	void GetNumbersImpl(std::size_t position, DefUIntType sum, DefUIntType remainder, T number, Functor &callback) const;
+
+	std::vector<Position> m_positions;
+	// Count of ways to choose positions from position on, so that constraints hold, given digit sum and remainder so far
+	std::vector<CountType> m_ways;
+	// Digit sum + 1, or 1 if digit sum isn't constrained (then sumWeight is 0)
+	DefUIntType m_sumStates = 1;
+	DefUIntType m_modulus = 1;
+};
+
+
+
+inline DigitConstraints MakePalindromeConstraints(const std::vector<palindrome::DigitRange> &ranges)
+{
+	DigitConstraints constraints;
+	constraints.palindrome = true;
+	for(const palindrome::DigitRange &range : ranges)
+		constraints.allowedDigits.push_back(GetDigitMask(range));
+	return constraints;
+}
+
+
+template<typename T, typename CountType>
+DigitDP<T, CountType>::DigitDP(const DigitConstraints &constraints) :
+	m_sumStates(constraints.digitSum == DigitConstraints::kAnyDigitSum ? 1 : constraints.digitSum + 1),
+	m_modulus(constraints.modulus)
+{
+	const std::size_t digitCount = constraints.allowedDigits.size();
+	if(digitCount == 0 || digitCount > static_cast<std::size_t>(kMaxDigits<T>))
+		return;
+
+	// Place value and its remainder of every digit, the least significant first
+	std::vector<T> powers(digitCount, T(1));
+	std::vector<DefUIntType> powerRemainders(digitCount, 1 % m_modulus);
+	for(std::size_t i = 1; i < digitCount; i++)
+	{
+		powers[i] = static_cast<T>(powers[i - 1] * T(10));
+		powerRemainders[i] = static_cast<DefUIntType>(uint64_t(powerRemainders[i - 1]) * 10 % m_modulus);
+	}
+
+	const std::size_t positionCount = constraints.palindrome ? (digitCount + 1) / 2 : digitCount;
+	m_positions.resize(positionCount);
+	for(std::size_t i = 0; i < positionCount; i++)
+	{
+		Position &position = m_positions[i];
+		const std::size_t mirrored = digitCount - i - 1;
+		const bool paired = constraints.palindrome && mirrored != i;
+		position.mask = constraints.allowedDigits[i] & DigitConstraints::kAllDigits;
+		if(constraints.palindrome)
+			position.mask &= constraints.allowedDigits[mirrored];
+		if(i == 0 && digitCount > 1)
+			position.mask &= ~uint16_t(1);
+		position.sumWeight = constraints.digitSum == DigitConstraints::kAnyDigitSum ? 0 : (paired ? 2 : 1);
+		const uint64_t remainderWeight = (uint64_t(powerRemainders[mirrored]) + (paired ? powerRemainders[i] : 0)) % m_modulus;
+		for(uint8_t digit = 0; digit < 10; digit++)
+			position.remainders[digit] = static_cast<DefUIntType>(remainderWeight * digit % m_modulus);
+		position.place = paired ? static_cast<T>(powers[mirrored] + powers[i]) : powers[mirrored];
+	}
+
+	// Filled from the last position, every state looks up states of the next one
+	m_ways.assign((positionCount + 1) * m_sumStates * m_modulus, CountType(0));
+	if(constraints.remainder < m_modulus)
+		m_ways[GetIndex(positionCount, m_sumStates - 1, constraints.remainder)] = CountType(1);
+	for(std::size_t position = positionCount; position-- > 0;)
+	{
+		for(DefUIntType sum = 0; sum < m_sumStates; sum++)
+		{
+			for(DefUIntType remainder = 0; remainder < m_modulus; remainder++)
+			{
+				CountType ways = CountType(0);
+				for(uint8_t digit = 0; digit < 10; digit++)
+				{
+					DefUIntType nextSum = sum, nextRemainder = remainder;
+					if((m_positions[position].mask >> digit) & 1 && Advance(position, digit, nextSum, nextRemainder))
+						ways = ways + GetWays(position + 1, nextSum, nextRemainder);
+				}
+				m_ways[GetIndex(position, sum, remainder)] = ways;
+			}
+		}
+	}
+
+	// Matches go in ascending order, so if the biggest one fits, every one does
+	if(digitCount == static_cast<std::size_t>(kMaxDigits<T>) && !BiggestFits())
+	{
+		m_positions.clear();
+		m_ways.clear();
+	}
+}
+
+template<typename T, typename CountType>
+bool DigitDP<T, CountType>::Advance(std::size_t position, uint8_t digit, DefUIntType &sum, DefUIntType &remainder) const
+{
+	sum += m_positions[position].sumWeight * digit;
+	const DefUIntType added = m_positions[position].remainders[digit];
+	remainder = remainder >= m_modulus - added ? remainder - (m_modulus - added) : remainder + added;
+	return sum < m_sumStates;
+}
+
+template<typename T, typename CountType>
+bool DigitDP<T, CountType>::BiggestFits() const
+{
+	if(Count() == CountType(0))
+		return true;
+	T biggest = T(0);
+	DefUIntType sum = 0, remainder = 0;
+	for(std::size_t position = 0; position < m_positions.size(); position++)
+	{
+		for(uint8_t digit = 10; digit-- > 0;)
+		{
+			DefUIntType nextSum = sum, nextRemainder = remainder;
+			if(!((m_positions[position].mask >> digit) & 1) || !Advance(position, digit, nextSum, nextRemainder) || GetWays(position + 1, nextSum, nextRemainder) == CountType(0))
+				continue;
+			if(digit != 0 && (std::numeric_limits<T>::max() - biggest) / T(digit) < m_positions[position].place)
+				return false;
+			biggest = static_cast<T>(biggest + m_positions[position].place * T(digit));
+			sum = nextSum;
+			remainder = nextRemainder;
+			break;
+		}
+	}
+	return true;
+}
+
+template<typename T, typename CountType>
+template<typename Functor>
+void DigitDP<T, CountType>::GetNumbers(Functor callback) const
+{
+	if(Count() != CountType(0))
+		GetNumbersImpl(0, 0, 0, T(0), callback);
+}
+
+template<typename T, typename CountType>
+template<typename Functor>
+void DigitDP<T, CountType>::GetNumbersImpl(std::size_t position, DefUIntType sum, DefUIntType remainder, T number, Functor &callback) const
+{
+	if(position == m_positions.size())
+	{
+		callback(number);
+		return;
+	}
+	const Position &current = m_positions[position];
+	for(uint8_t digit = 0; digit < 10; digit++)
+	{
+		DefUIntType nextSum = sum, nextRemainder = remainder;
+		if((current.mask >> digit) & 1 && Advance(position, digit, nextSum, nextRemainder) && GetWays(position + 1, nextSum, nextRemainder) != CountType(0))
+			GetNumbersImpl(position + 1, nextSum, nextRemainder, static_cast<T>(number + current.place * T(digit)), callback);
+	}
+}
+
+template<typename T, typename CountType>
+T DigitDP<T, CountType>::GetNumberWithIndex(CountType index) const
+{
+	if(!(index < Count()))
+		return T(0);
+	T number = T(0);
+	DefUIntType sum = 0, remainder = 0;
+	for(std::size_t position = 0; position < m_positions.size(); position++)
+	{
+		// Skip whole subtrees of smaller digits
+		for(uint8_t digit = 0; digit < 10; digit++)
+		{
+			DefUIntType nextSum = sum, nextRemainder = remainder;
+			if(!((m_positions[position].mask >> digit) & 1) || !Advance(position, digit, nextSum, nextRemainder))
+				continue;
+			const CountType ways = GetWays(position + 1, nextSum, nextRemainder);
+			if(index < ways)
+			{
+				number = static_cast<T>(number + m_positions[position].place * T(digit));
+				sum = nextSum;
+				remainder = nextRemainder;
+				break;
+			}
+			index = index - ways;
+		}
+	}
+	return number;
+}
+
+
+template<typename T, typename CountType>
+DigitDPIterator<T, CountType>::DigitDPIterator(const DigitDP<T, CountType> *dp)
+{
+	if(dp->Count() == CountType(0))
+		return;
+	m_dp = dp;
+	FillSmallest(0);
+}
+
+template<typename T, typename CountType>
+void DigitDPIterator<T, CountType>::FillSmallest(std::size_t position)
+{
+	for(; position < m_dp->m_positions.size(); position++)
+	{
+		for(uint8_t digit = 0; digit < 10; digit++)
+		{
+			DefUIntType sum = m_sums[position], remainder = m_remainders[position];
+			if((m_dp->m_positions[position].mask >> digit) & 1 && m_dp->Advance(position, digit, sum, remainder) && m_dp->GetWays(position + 1, sum, remainder) != CountType(0))
+			{
+				m_digits[position] = digit;
+				m_sums[position + 1] = sum;
+				m_remainders[position + 1] = remainder;
+				m_number = static_cast<T>(m_number + m_dp->m_positions[position].place * T(digit));
+				break;
+			}
+		}
+	}
+}
+
+template<typename T, typename CountType>
+DigitDPIterator<T, CountType> &DigitDPIterator<T, CountType>::operator++()
+{
+	for(std::size_t position = m_dp->m_positions.size(); position-- > 0;)
+	{
+		const auto &current = m_dp->m_positions[position];
+		m_number = static_cast<T>(m_number - current.place * T(m_digits[position]));
+		for(uint8_t digit = static_cast<uint8_t>(m_digits[position] + 1); digit < 10; digit++)
+		{
+			DefUIntType sum = m_sums[position], remainder = m_remainders[position];
+			if((current.mask >> digit) & 1 && m_dp->Advance(position, digit, sum, remainder) && m_dp->GetWays(position + 1, sum, remainder) != CountType(0))
+			{
+				m_digits[position] = digit;
+				m_sums[position + 1] = sum;
+				m_remainders[position + 1] = remainder;
+				m_number = static_cast<T>(m_number + current.place * T(digit));
+				FillSmallest(position + 1);
+				return *this;
+			}
+		}
+	}
+	// Every position is at its last digit
+	*this = DigitDPIterator();
+	return *this;
+}
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_DIGIT_DP_HPP
@@ -0,0 +1,164 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROME_PRIMES_HPP
+#define TOLIK_ALGORITHMS_PALINDROME_PRIMES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Algorithms/PalindromesParallel.hpp"
+#include "Math/Primes.hpp"
+#include "Math/Utils.hpp"
+
+// Palindromic primes up to 64 bits
+// Wheel by 2 and 5 is built into generation: the outer digit pair is fixed to 1, 3, 7 or 9, other ones give multiples.
+// Palindromes with even digit count are multiples of 11, so the only prime among them (11) is passed without search.
+// Palindromes are generated in blocks, and every block goes through FilterPrimes from Math/Primes.hpp:
+// small divisors, then Miller-Rabin with powers of several numbers computed in lockstep
+
+namespace Tolik
+{
+namespace palindrome
+{
+// Palindromic primes with digit count in range, first - inclusive, second - exclusive, in ascending order
+// callback(uint64_t prime); digit counts above 19 give nothing
+// Example: (DigitCountRange(1, 4), callback) = 2 3 5 7 11 101 131 151 181 191 313 353 373 383 727 757 787 797 919 929
+template<typename T, typename Functor>
+inline void GetPalindromicPrimesDigitCountRange(const DigitCountRange<T> &digitCountRange, Functor callback);
+
+// Same primes as GetPalindromesDigitRange(ranges, callback) would pass through IsPrime, in ascending order
+template<typename Functor>
+inline void GetPalindromicPrimesDigitRange(const std::vector<DigitRange> &ranges, Functor callback);
+
+// Same primes in the same order, but blocks are generated and tested on threadCount threads (0 = one per hardware thread)
+// callback is called only from calling thread, while the other threads go on
+template<typename T, typename Functor>
+inline void GetPalindromicPrimesDigitCountRangeParallel(const DigitCountRange<T> &digitCountRange, Functor callback, std::size_t threadCount = 0);
+
+template<typename Functor>
+inline void GetPalindromicPrimesDigitRangeParallel(const std::vector<DigitRange> &ranges, Functor callback, std::size_t threadCount = 0);
+
+
+namespace detail
+{
+// Palindromes tested at once, same size as in FilterPalindromes
+constexpr inline std::size_t kPrimeBlockSize = 1024;
+// The only last (and so first) digits of prime with more than one digit
+constexpr inline uint8_t kPrimeOuterDigits[] = { 1, 3, 7, 9 };
+
+// Primes the outer digit wheel doesn't reach: one digit ones and 11
+template<typename Functor>
+void GetShortPalindromicPrimes(const std::vector<DigitRange> &ranges, Functor &callback)
+{
+	if(ranges.size() == 1)
+	{
+		for(uint8_t prime : { 2, 3, 5, 7 })
+		{
+			if(ranges[0].min <= prime && prime < ranges[0].max)
+				callback(uint64_t(prime));
+		}
+	}
+	else if(ranges.size() == 2 && ranges[0].min <= 1 && 1 < ranges[0].max && ranges[1].min <= 1 && 1 < ranges[1].max)
+		callback(uint64_t(11));
+}
+
+// Half size valid ranges (see GetValidRanges) with the outer digit fixed, one block per digit from kPrimeOuterDigits
+// in ascending order. Empty for digit counts that have no palindromic primes past GetShortPalindromicPrimes
+inline auto GetPrimeValidRangeBlocks(const std::vector<DigitRange> &ranges) -> std::vector<std::vector<DigitRange>>
+{
+	std::vector<std::vector<DigitRange>> blocks;
+	if(ranges.size() < 3 || ranges.size() % 2 == 0 || ranges.size() > static_cast<std::size_t>(kMaxDigits<uint64_t>))
+		return blocks;
+	const std::vector<DigitRange> validRanges = GetValidRanges(ranges);
+	if(!HasValidDigits(validRanges))
+		return blocks;
+	for(uint8_t digit : kPrimeOuterDigits)
+	{
+		if(validRanges[0].min <= digit && digit < validRanges[0].max)
+		{
+			blocks.push_back(validRanges);
+			blocks.back()[0] = DigitRange(digit, static_cast<uint8_t>(digit + 1));
+		}
+	}
+	return blocks;
+}
+
+// Blocks have odd digit count, so it is restored from their size
+inline DefUIntType GetPrimeBlockDigitCount(const std::vector<DigitRange> &validRanges)
+{ return static_cast<DefUIntType>(validRanges.size() * 2 - 1); }
+
+template<typename Functor>
+void GetPalindromicPrimesDigitRangeImpl(const std::vector<DigitRange> &ranges, Functor &callback)
+{
+	GetShortPalindromicPrimes(ranges, callback);
+	const std::vector<std::vector<DigitRange>> blocks = GetPrimeValidRangeBlocks(ranges);
+	if(blocks.empty())
+		return;
+
+	std::vector<uint64_t> buffer(kPrimeBlockSize);
+	auto filter = [&](const uint64_t *block, std::size_t count) { Tolik::detail::ForEachPrime(block, count, callback); };
+	PalindromeBlockWriter<uint64_t, decltype(filter)> writer(buffer.data(), buffer.size(), filter);
+	for(const std::vector<DigitRange> &validRanges : blocks)
+		IteratePalindromeRuns(uint64_t(0), GetPrimeBlockDigitCount(validRanges), GetPrimeBlockDigitCount(validRanges), &validRanges, writer);
+	writer.Flush();
+}
+
+// Every block is split into subtrees as in GetPalindromesDigitRangeOrdered, subtree is generated into thread's own buffer
+template<typename Functor>
+void RunPalindromicPrimeTasks(const std::vector<std::vector<DigitRange>> &blocks, Functor &callback, std::size_t threadCount)
+{
+	std::vector<PalindromeTask<uint64_t>> tasks;
+	for(const std::vector<DigitRange> &validRanges : blocks)
+		AppendPalindromeTasks<uint64_t>(tasks, GetPrimeBlockDigitCount(validRanges), &validRanges, threadCount * kPalindromeTasksPerThread);
+
+	std::vector<std::vector<uint64_t>> buffers(threadCount, std::vector<uint64_t>(kPrimeBlockSize));
+	RunTasksOrdered<uint64_t>(tasks.size(), threadCount, [&](std::size_t taskIndex, std::size_t threadIndex, std::vector<uint64_t> &found)
+	{
+		const PalindromeTask<uint64_t> &task = tasks[taskIndex];
+		auto collect = [&](uint64_t prime) { found.push_back(prime); };
+		auto filter = [&](const uint64_t *block, std::size_t count) { Tolik::detail::ForEachPrime(block, count, collect); };
+		PalindromeBlockWriter<uint64_t, decltype(filter)> writer(buffers[threadIndex].data(), kPrimeBlockSize, filter);
+		IteratePalindromeRuns(task.number, task.digit, task.totalDigits, task.validRanges, writer);
+		writer.Flush();
+	}, callback);
+}
+} // detail
+
+
+template<typename T, typename Functor>
+void GetPalindromicPrimesDigitCountRange(const DigitCountRange<T> &digitCountRange, Functor callback)
+{
+	for(T digit = std::max(digitCountRange.min, T(1)); digit < digitCountRange.max && digit <= T(kMaxDigits<uint64_t>); digit = digit + T(1))
+		detail::GetPalindromicPrimesDigitRangeImpl(std::vector<DigitRange>(static_cast<std::size_t>(digit), DigitRange(0, 10)), callback);
+}
+
+template<typename Functor>
+void GetPalindromicPrimesDigitRange(const std::vector<DigitRange> &ranges, Functor callback)
+{ detail::GetPalindromicPrimesDigitRangeImpl(ranges, callback); }
+
+template<typename T, typename Functor>
+void GetPalindromicPrimesDigitCountRangeParallel(const DigitCountRange<T> &digitCountRange, Functor callback, std::size_t threadCount)
+{
+	std::vector<std::vector<DigitRange>> blocks;
+	for(T digit = std::max(digitCountRange.min, T(1)); digit < digitCountRange.max && digit <= T(kMaxDigits<uint64_t>); digit = digit + T(1))
+	{
+		const std::vector<DigitRange> ranges(static_cast<std::size_t>(digit), DigitRange(0, 10));
+		// Short primes are the smallest ones, so they go before any block
+		detail::GetShortPalindromicPrimes(ranges, callback);
+		for(std::vector<DigitRange> &validRanges : detail::GetPrimeValidRangeBlocks(ranges))
+			blocks.push_back(std::move(validRanges));
+	}
+	detail::RunPalindromicPrimeTasks(blocks, callback, detail::GetThreadCount(threadCount));
+}
+
+template<typename Functor>
+void GetPalindromicPrimesDigitRangeParallel(const std::vector<DigitRange> &ranges, Functor callback, std::size_t threadCount)
+{
+	detail::GetShortPalindromicPrimes(ranges, callback);
+	detail::RunPalindromicPrimeTasks(detail::GetPrimeValidRangeBlocks(ranges), callback, detail::GetThreadCount(threadCount));
+}
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROME_PRIMES_HPP
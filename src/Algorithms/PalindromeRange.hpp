@@ -0,0 +1,186 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROME_RANGE_HPP
+#define TOLIK_ALGORITHMS_PALINDROME_RANGE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Math/Utils.hpp"
+
+// Lazy alternative to callback enumeration from Palindromes.hpp
+// Iterator keeps upper half of palindrome as digit odometer and changes number by the same differences as detail::IteratePalindromes,
+// so there is no recursion, loop can be left with break and range can be composed with algorithms and std::ranges adaptors
+// Example: for(uint32_t number : PalindromeRange<uint32_t>(DigitCountRange<int>(3, 5))) { if(number % 7 == 0) break; }
+
+namespace Tolik
+{
+namespace palindrome
+{
+// Forward iterator over palindromes in ascending order, digit count by digit count
+// The longest digit count of T ends at the biggest palindrome that fits, then iterator goes to end
+// Dereference returns computed value, like std::ranges::iota_view iterator does
+template<typename T>
+class PalindromeIterator
+{
+public:
+	using value_type = T;
+	using difference_type = std::ptrdiff_t;
+	using reference = T;
+	using pointer = void;
+	// Legacy forward iterators must return reference, so for old algorithms it is only input iterator
+	using iterator_category = std::input_iterator_tag;
+	using iterator_concept = std::forward_iterator_tag;
+
+	constexpr PalindromeIterator() {}
+	// Iterator at the first palindrome with digitCount digits, or end iterator if endDigitCount <= digitCount
+	// withZero makes 1-digit palindromes start from 0
+	constexpr PalindromeIterator(DefUIntType digitCount, DefUIntType endDigitCount, bool withZero = false);
+
+	constexpr T operator*() const { return m_number; }
+
+	// Amortized O(1): middle digit changes 9 times out of 10, next pair 9 times out of 100 and so on
+	constexpr PalindromeIterator &operator++();
+	constexpr PalindromeIterator operator++(int) { PalindromeIterator old = *this; ++*this; return old; }
+
+	// Digit count of current palindrome, endDigitCount for end iterator
+	constexpr DefUIntType GetDigitCount() const { return m_digitCount; }
+
+	friend constexpr bool operator==(const PalindromeIterator &a, const PalindromeIterator &b)
+	{ return a.m_digitCount == b.m_digitCount && a.m_number == b.m_number; }
+	friend constexpr bool operator!=(const PalindromeIterator &a, const PalindromeIterator &b)
+	{ return !(a == b); }
+
+private:
+	static constexpr std::size_t kMaxHalfDigits = (kMaxDigits<T> + 1) / 2;
+	// Palindromes after it with the same digit count don't fit into T
+	static constexpr T kLastPalindrome = PrevPalindrome(std::numeric_limits<T>::max());
+
+	// Move to the first palindrome with digitCount digits
+	constexpr void Reset(DefUIntType digitCount);
+
+	T m_number = T(0);
+	// Difference between palindromes that differ only in the middle digit (pair), it is used on almost every increment
+	T m_innerDiff = T(0);
+	DefUIntType m_digitCount = 0;
+	DefUIntType m_endDigitCount = 0;
+	// Upper half of palindrome, the most significant digit first
+	std::array<uint8_t, kMaxHalfDigits> m_digits{};
+};
+
+// Palindromes with digit count in range, first - inclusive, second - exclusive, same as GetPalindromesDigitCountRange
+// Digit counts that don't fit into T are cut off, the longest one ends at the biggest palindrome that fits
+// Range doesn't own anything, so it is a view and its iterators stay valid when range is destroyed
+// Example: PalindromeRange<int>(DigitCountRange<int>(1, 3)) = 0 1 2 ... 9 11 22 ... 99
+template<typename T>
+class PalindromeRange
+{
+public:
+	using iterator = PalindromeIterator<T>;
+	using const_iterator = PalindromeIterator<T>;
+
+	constexpr PalindromeRange() {}
+	template<typename U>
+	constexpr explicit PalindromeRange(const DigitCountRange<U> &digitCountRange);
+
+	constexpr iterator begin() const { return iterator(m_minDigitCount, m_endDigitCount, m_withZero); }
+	constexpr iterator end() const { return iterator(m_endDigitCount, m_endDigitCount); }
+	constexpr bool empty() const { return m_endDigitCount <= m_minDigitCount; }
+
+private:
+	DefUIntType m_minDigitCount = 1;
+	DefUIntType m_endDigitCount = 1;
+	bool m_withZero = false;
+};
+
+
+
+template<typename T>
+constexpr PalindromeIterator<T>::PalindromeIterator(DefUIntType digitCount, DefUIntType endDigitCount, bool withZero) : m_endDigitCount(endDigitCount)
+{
+	static_assert(std::numeric_limits<T>::is_specialized, "Need to know std::numeric_limits<T> in order to know the longest palindrome of this type");
+
+	Reset(digitCount);
+	if(withZero && m_digitCount == 1)
+	{
+		m_digits[0] = 0;
+		m_number = T(0);
+	}
+}
+
+template<typename T>
+constexpr PalindromeIterator<T> &PalindromeIterator<T>::operator++()
+{
+	// The next one would overflow
+	if(m_number == kLastPalindrome)
+	{
+		Reset(m_endDigitCount);
+		return *this;
+	}
+
+	const DefUIntType halfDigits = (m_digitCount + 1) / 2;
+	for(DefUIntType i = halfDigits; i-- > 0;)
+	{
+		const T diff = i + 1 == halfDigits ? m_innerDiff : detail::GetDiff<T>(static_cast<DefUIntType>(m_digitCount - 2 * i), m_digitCount);
+		if(m_digits[i] < 9)
+		{
+			m_digits[i]++;
+			m_number = m_number + diff;
+			return *this;
+		}
+
+		// Digit (pair) goes from 9 back to 0 and carries to outer one
+		m_digits[i] = 0;
+		m_number = m_number - diff * T(9);
+	}
+
+	// All digits were 9, so it was the last palindrome with this digit count
+	Reset(m_digitCount + 1);
+	return *this;
+}
+
+template<typename T>
+constexpr void PalindromeIterator<T>::Reset(DefUIntType digitCount)
+{
+	if(m_endDigitCount <= digitCount)
+	{
+		m_digitCount = m_endDigitCount;
+		m_number = T(0);
+		return;
+	}
+
+	m_digitCount = digitCount;
+	m_digits = {};
+	m_digits[0] = 1;
+	// 10^(digitCount - 1) + 1, or 1 for 1-digit palindrome
+	m_number = detail::GetDiff<T>(digitCount, digitCount);
+	m_innerDiff = detail::GetDiff<T>(static_cast<DefUIntType>(2 - digitCount % 2), digitCount);
+}
+
+
+template<typename T>
+template<typename U>
+constexpr PalindromeRange<T>::PalindromeRange(const DigitCountRange<U> &digitCountRange) :
+	m_minDigitCount(static_cast<DefUIntType>(std::clamp(digitCountRange.min, U(1), std::clamp(digitCountRange.max, U(1), U(kMaxDigits<T> + 1))))),
+	m_endDigitCount(static_cast<DefUIntType>(std::clamp(digitCountRange.max, U(1), U(kMaxDigits<T> + 1)))),
+	// 0 has no digits, it goes before 1-digit palindromes the same way GetPalindromesDigitCountRange passes it
+	m_withZero(digitCountRange.min < U(2) && U(1) < digitCountRange.max)
+{}
+} // palindrome
+} // Tolik
+
+#if __cplusplus >= 202002L
+// Range holds only digit counts, so it is cheap to copy and iterators don't point into it
+template<typename T>
+constexpr inline bool std::ranges::enable_view<Tolik::palindrome::PalindromeRange<T>> = true;
+template<typename T>
+constexpr inline bool std::ranges::enable_borrowed_range<Tolik::palindrome::PalindromeRange<T>> = true;
+#endif
+
+#endif // TOLIK_ALGORITHMS_PALINDROME_RANGE_HPP
@@ -0,0 +1,76 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROME_TABLE_HPP
+#define TOLIK_ALGORITHMS_PALINDROME_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Algorithms/PalindromeRange.hpp"
+#include "Algorithms/Search.hpp"
+#include "Math/Utils.hpp"
+
+// Sorted palindrome tables built at compile time, so there is nothing to generate at startup
+// Tables are filled by PalindromeRange iterator, which is constexpr and needs no std::vector.
+// GenerateArray from Utilities/Type.hpp isn't used: it recurses once per element, and tables have thousands of them.
+// Default constant evaluation limits of compilers allow tables up to 8 digits (about 2 * 10^4 palindromes),
+// bigger ones need -fconstexpr-ops-limit (GCC) or -fconstexpr-steps (Clang)
+// Example: kPalindromeTable<uint16_t, 1, 3> = { 0, 1, 2, ... 9, 11, 22, ... 99 }
+//          kPalindromeEytzinger<uint32_t, 1, 7>.LowerBound(uint32_t(12345)) = 223 (index of 12421)
+
+namespace Tolik
+{
+namespace palindrome
+{
+// Count of palindromes with digit count in [minDigits, maxDigits), with 0 if minDigits < 2
+constexpr inline std::size_t GetPalindromeTableSize(DefUIntType minDigits, DefUIntType maxDigits)
+{
+	std::size_t size = minDigits < 2 && 1 < maxDigits ? 1 : 0;
+	for(DefUIntType digits = std::max<DefUIntType>(minDigits, 1); digits < maxDigits; digits++)
+		size += GetPalindromeCountInNDigitNumber<std::size_t>(digits);
+	return size;
+}
+
+// Palindromes with digit count in [MinDigits, MaxDigits) in ascending order, same as GetPalindromesDigitCountRange passes
+// Every digit count must fit into T
+template<typename T, DefUIntType MinDigits, DefUIntType MaxDigits>
+constexpr inline auto MakePalindromeTable() -> std::array<T, GetPalindromeTableSize(MinDigits, MaxDigits)>;
+
+template<typename T, DefUIntType MinDigits, DefUIntType MaxDigits>
+constexpr inline std::array<T, GetPalindromeTableSize(MinDigits, MaxDigits)> kPalindromeTable = MakePalindromeTable<T, MinDigits, MaxDigits>();
+
+// The same table in Eytzinger layout, for membership and rank queries
+template<typename T, DefUIntType MinDigits, DefUIntType MaxDigits>
+constexpr inline EytzingerArray<T, GetPalindromeTableSize(MinDigits, MaxDigits)> kPalindromeEytzinger(kPalindromeTable<T, MinDigits, MaxDigits>);
+
+#if __cplusplus >= 202002L
+// Palindromes with digits in ranges, same as GetPalindromesDigitRange(ranges, callback) passes
+// std::vector can be used in constant evaluation from c++20, so any ranges work. N must be CountPalindromes(ranges)
+// Example: constexpr auto table = MakePalindromeTable<int, 12>({ {2, 6}, {3, 7}, {1, 8}, {2, 5} }); // 2332 ... 4664
+template<typename T, std::size_t N>
+constexpr std::array<T, N> MakePalindromeTable(const std::vector<DigitRange> &ranges)
+{
+	std::array<T, N> table{};
+	std::size_t size = 0;
+	GetPalindromesDigitRange(ranges, [&](T number) { table[size++] = number; });
+	return table;
+}
+#endif
+
+
+
+template<typename T, DefUIntType MinDigits, DefUIntType MaxDigits>
+constexpr auto MakePalindromeTable() -> std::array<T, GetPalindromeTableSize(MinDigits, MaxDigits)>
+{
+	static_assert(MaxDigits <= DefUIntType(kMaxDigits<T>), "Palindromes of every digit count must fit into T");
+	std::array<T, GetPalindromeTableSize(MinDigits, MaxDigits)> table{};
+	std::size_t size = 0;
+	for(T number : PalindromeRange<T>(DigitCountRange<DefUIntType>(MinDigits, MaxDigits)))
+		table[size++] = number;
+	return table;
+}
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROME_TABLE_HPP
@@ -4,12 +4,22 @@
 #include <functional>
 #include <utility>
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <cassert>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 #include "gcem.hpp"
 
 #include "Setup.hpp"
 #include "Math/Constants.hpp"
 #include "Math/Utils.hpp"
+#include "Math/Digits.hpp"
 #include "Utilities/Type.hpp"
 
 namespace Tolik
@@ -48,26 +58,110 @@ constexpr inline void GetPalindromesDigitCountRange(const DigitCountRange<T> &di
 template<typename Functor>
 constexpr inline void GetPalindromesDigitRange(const std::vector<DigitRange> &ranges, Functor callback);
 
+// Block variants: the same palindromes in the same order are written into buffer,
+// callback(const T *block, std::size_t count) is called once per full block and once for the rest
+// Palindromes that differ only in the middle digit (pair) are written by one loop, so there is no call per palindrome
+// and consumer gets contiguous memory it can filter with SIMD. bufferSize must not be 0, it is asserted
+// Example: GetAllPalindromes(buffer, 4096, [](const uint32_t *block, std::size_t count) { ... });
+template<typename T, typename Functor>
+inline void GetAllPalindromes(T *buffer, std::size_t bufferSize, Functor callback);
+
+template<typename T, typename U, typename Functor>
+inline void GetPalindromesDigitCountRange(const DigitCountRange<U> &digitCountRange, T *buffer, std::size_t bufferSize, Functor callback);
+
+template<typename T, typename Functor>
+inline void GetPalindromesDigitRange(const std::vector<DigitRange> &ranges, T *buffer, std::size_t bufferSize, Functor callback);
+
+#if __cplusplus >= 202002L
+// Same as above with callback(std::span<const T> block)
+template<typename T, typename Functor>
+inline void GetAllPalindromes(std::span<T> buffer, Functor callback)
+{ GetAllPalindromes(buffer.data(), buffer.size(), [&](const T *block, std::size_t count) { callback(std::span<const T>(block, count)); }); }
+
+template<typename T, typename U, typename Functor>
+inline void GetPalindromesDigitCountRange(const DigitCountRange<U> &digitCountRange, std::span<T> buffer, Functor callback)
+{ GetPalindromesDigitCountRange(digitCountRange, buffer.data(), buffer.size(), [&](const T *block, std::size_t count) { callback(std::span<const T>(block, count)); }); }
+
+template<typename T, typename Functor>
+inline void GetPalindromesDigitRange(const std::vector<DigitRange> &ranges, std::span<T> buffer, Functor callback)
+{ GetPalindromesDigitRange(ranges, buffer.data(), buffer.size(), [&](const T *block, std::size_t count) { callback(std::span<const T>(block, count)); }); }
+#endif
+
 template<typename T>
 constexpr bool IsPalindrome(T number);
 
+// Same as IsPalindrome(number) for number that view was made from
+template<typename T>
+constexpr bool IsPalindrome(const DigitView<T> &view);
+
 // Interesting concept with palindrome indexing
+// Index is position of palindrome among all positive palindromes in ascending order
 // If number given is not a palindrome, 0 is returned
 // Thus indexing starts with 1
-// Example: 353 = 9 * 3 + 1 + 5 + 1 = 33
-// Same as:
+// Example: 353 = 9 (1-digit) + 9 (2-digit) + (35 - 10 + 1) = 44
 template<typename T, typename U = DefIntType>
 constexpr U GetIndexOfPalindrome(T palindrome);
 
-// Interesting concept with palindrome indexing
-// If number given is not a palindrome, -1 is returned
-// Example: 33 = 353
-//template<typename T = DefIntType>
-//constexpr T GetPalindromeWithIndex(DefUIntType index);
+// Same as GetIndexOfPalindrome(palindrome) for number that view was made from
+template<typename U = DefIntType, typename T>
+constexpr U GetIndexOfPalindrome(const DigitView<T> &view);
+
+// Inverse of GetIndexOfPalindrome: palindrome at index among all positive palindromes in ascending order
+// O(digit count), so enumeration can be started from any position without going through palindromes before it
+// If index is 0 or palindrome doesn't fit into T, 0 is returned
+// Example: 44 = 353
+template<typename T = DefIntType, typename U>
+constexpr T GetPalindromeWithIndex(U index);
 
+// Count of palindromes with exactly numberDigits digits (0 isn't counted)
+// Example: 1 = 9 (1..9); 2 = 9 (11..99); 3 = 90 (101..999)
 template<typename T = DefUIntType>
 constexpr inline T GetPalindromeCountInNDigitNumber(DefUIntType numberDigits) 
-{ return 9 * FastPower10(numberDigits / 2); }
+{ return numberDigits == 0 ? T(0) : T(9) * FastPower10<T>((numberDigits - 1) / 2); }
+
+// The smallest palindrome not less than number, found by mirroring its upper half, without enumeration
+// If it doesn't fit into T, 0 is returned. Negative numbers give 0
+// Example: 12345 = 12421; 999 = 999; 1000 = 1001
+template<typename T>
+constexpr T NextPalindrome(T number);
+
+// The biggest palindrome not bigger than number, see NextPalindrome
+// Example: 12345 = 12321; 1000 = 999
+template<typename T>
+constexpr T PrevPalindrome(T number);
+
+// Same as out[i] = NextPalindrome(in[i]) for i in [0, count)
+template<typename T>
+inline void NextPalindrome(const T *in, T *out, std::size_t count);
+
+// Same as out[i] = PrevPalindrome(in[i]) for i in [0, count)
+template<typename T>
+inline void PrevPalindrome(const T *in, T *out, std::size_t count);
+
+#if __cplusplus >= 202002L
+// Only min(in.size(), out.size()) values are processed
+template<typename T>
+inline void NextPalindrome(std::span<const T> in, std::span<T> out)
+{ NextPalindrome(in.data(), out.data(), std::min(in.size(), out.size())); }
+
+template<typename T>
+inline void PrevPalindrome(std::span<const T> in, std::span<T> out)
+{ PrevPalindrome(in.data(), out.data(), std::min(in.size(), out.size())); }
+#endif
+
+// Count of palindromes in [min, max], both inclusive, in O(digit count) without enumerating them
+// Negative numbers aren't counted, the same way they aren't enumerated
+// Example: (100, 200) = 10 (101 111 ... 191)
+template<typename R = std::size_t, typename T, typename U>
+constexpr R CountPalindromes(T min, U max);
+
+// Count of palindromes GetPalindromesDigitRange(ranges, callback) passes, in O(ranges.size())
+// Example: { {2, 6}, {3, 7}, {1, 8}, {2, 5} } = 3 * 4 = 12 (2332 ... 4664)
+template<typename R = std::size_t>
+#if __cplusplus >= 202002L
+constexpr
+#endif
+inline R CountPalindromes(const std::vector<DigitRange> &ranges);
 
 template<typename T>
 constexpr inline DefUIntType GetCountOfDigitsFromPalindromeIndex(T palindromeIndex)
@@ -112,9 +206,82 @@ constexpr
 #endif
 inline auto GetValidRanges(const std::vector<DigitRange> &ranges) -> std::vector<DigitRange>;
 
+// Valid ranges of blocks that together hold all palindromes with digit count of max that are not bigger than max
+// Per digit ranges from GetValidRangesFromNumber(max) can't do it: 161 <= 255, but 6 > 5
+// Block i has upper i digits equal to ones of max and digit i below it, digits after it are free,
+// the last block is upper half of max itself, if its palindrome fits. Blocks go in ascending order
+// Example: 255 = { { {0, 2}, {0, 10} }, { {2, 3}, {0, 5} }, { {2, 3}, {5, 6} } }
+template<typename T>
+#if __cplusplus >= 202002L
+constexpr
+#endif
+inline auto GetValidRangeBlocksUpTo(T max) -> std::vector<std::vector<DigitRange>>;
+
+// Sign of difference between palindrome with the same digit count and upper half as number, and number itself
+// Example: 255 = -1 (252); 321 = 1 (323); 121 = 0
+template<typename T>
+constexpr int CompareUpperHalfPalindrome(T number);
+
+// Lower half of palindrome with digits digits and given upper half
+// Example: (123, 5) = 21; (123, 6) = 321
+template<typename T>
+constexpr T ReverseUpperHalf(T half, DefUIntType digits);
+
+// half * 10^(digits / 2) + lower, 0 if it doesn't fit into T
+template<typename T>
+constexpr T JoinHalves(T half, T lower, DefUIntType digits);
+
+// Palindrome with digits digits and given upper half, 0 if it doesn't fit into T
+// Example: (123, 5) = 12321; (123, 6) = 123321
+template<typename T>
+constexpr T MirrorUpperHalf(T half, DefUIntType digits)
+{ return JoinHalves(half, ReverseUpperHalf(half, digits), digits); }
+
+// Count of palindromes in [0, max], 0 for negative max
+template<typename R, typename T>
+constexpr R CountPalindromesUpTo(T max);
+
+// IteratePalindromesRanging passes at least one number, so it can be called only if every position has valid digit
+#if __cplusplus >= 202002L
+constexpr
+#endif
+inline bool HasValidDigits(const std::vector<DigitRange> &validRanges);
+
 template<typename ReturnType, typename U, typename Functor>
 constexpr void IteratePalindromes(ReturnType &number, U digit, U totalDigits, Functor callback);
 
+// Digits allowed in pair digit (counted as in IteratePalindromes), validRanges = nullptr means that every digit is allowed
+inline DigitRange GetDigitPairRange(DefUIntType digit, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges)
+{
+	const DigitRange range = validRanges == nullptr ? DigitRange(0, 10) : (*validRanges)[(totalDigits - digit) / 2];
+	// The most significant digit can't be 0
+	return digit == totalDigits ? DigitRange(std::max<uint8_t>(1, range.min), range.max) : range;
+}
+
+// Same order as IteratePalindromes and IteratePalindromesRanging, but palindromes that differ only in the middle digit (pair)
+// are passed at once: run(first, diff, count) stands for first, first + diff, ... first + diff * (count - 1)
+// Empty ranges give nothing
+template<typename T, typename Run>
+void IteratePalindromeRuns(T number, DefUIntType digit, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges, Run &run);
+
+// Run consumer for block variants, it keeps palindromes in buffer until it is full
+template<typename T, typename Functor>
+class PalindromeBlockWriter
+{
+public:
+	PalindromeBlockWriter(T *buffer, std::size_t bufferSize, Functor &callback) : m_buffer(buffer), m_bufferSize(bufferSize), m_callback(callback) {}
+
+	void operator()(T first, T diff, std::size_t count);
+	// Pass palindromes left in buffer
+	void Flush();
+
+private:
+	T *m_buffer;
+	std::size_t m_bufferSize;
+	std::size_t m_size = 0;
+	Functor &m_callback;
+};
+
 // Get palindromes with digits in number ranging.
 // digit is used for recursive iteration
 // totalDigits in this case also indicates if the number is odd
@@ -124,25 +291,31 @@ template<typename ReturnType, typename U, typename Functor>
 constexpr void IteratePalindromesRanging(ReturnType &number, U digit, U totalDigits, const std::vector<DigitRange> &validRanges, Functor callback);
 
 
+// lookup[1] = 1 is the middle digit of 1-digit palindrome, lookup[i] = 10^(i - 1) + 1, 0 if it doesn't fit into T
+// Built in integer arithmetic, gcem::pow gives floating-point values that would narrow in array initializer
 template<typename T>
-constexpr static T kGetDiffLookup[21] =
+constexpr inline std::array<T, 21> MakeGetDiffLookup()
 {
-	0, 1, 11, 101, kMaxDigits<T> > 3 ? 1001 : 0,
-    kMaxDigits<T> > 4 ?  (gcem::pow(10, 4) + 1) : 0,  kMaxDigits<T> > 5 ?  (gcem::pow(10, 5) + 1) : 0,  kMaxDigits<T> > 6 ?  (gcem::pow(10, 6) + 1) : 0,  kMaxDigits<T> > 7 ?  (gcem::pow(10, 7) + 1) : 0,
-    kMaxDigits<T> > 8 ?  (gcem::pow(10, 8) + 1) : 0,  kMaxDigits<T> > 9 ?  (gcem::pow(10, 9) + 1) : 0,  kMaxDigits<T> > 10 ? (gcem::pow(10, 10) + 1) : 0, kMaxDigits<T> > 11 ? (gcem::pow(10, 11) + 1) : 0, 
-    kMaxDigits<T> > 12 ? (gcem::pow(10, 12) + 1) : 0, kMaxDigits<T> > 13 ? (gcem::pow(10, 13) + 1) : 0, kMaxDigits<T> > 14 ? (gcem::pow(10, 14) + 1) : 0, kMaxDigits<T> > 15 ? (gcem::pow(10, 15) + 1) : 0,
-    kMaxDigits<T> > 16 ? (gcem::pow(10, 16) + 1) : 0, kMaxDigits<T> > 17 ? (gcem::pow(10, 17) + 1) : 0, kMaxDigits<T> > 18 ? (gcem::pow(10, 18) + 1) : 0, kMaxDigits<T> > 19 ? (gcem::pow(10, 19) + 1) : 0
-};
+	std::array<T, 21> lookup{};
+	// 10^(i - 1)
+	T power = T(1);
+	for(std::size_t i = 1; i < lookup.size() && static_cast<int>(i) - 1 < kMaxDigits<T>; i++)
+	{
+		lookup[i] = i == 1 ? T(1) : static_cast<T>(power + T(1));
+		if(static_cast<int>(i) < kMaxDigits<T>)
+			power = static_cast<T>(power * T(10));
+	}
+	return lookup;
+}
+
+template<typename T>
+constexpr inline std::array<T, 21> kGetDiffLookup = MakeGetDiffLookup<T>();
 
 // Get needed difference to get next palindrome
 // totalDigits is used to add offset
-// same as: (10^digit + 1) * (totalDigits - digit) / 2;
+// same as: (10^(digit - 1) + 1) * 10^((totalDigits - digit) / 2), where middle digit of odd palindrome has 1 instead of 10^0 + 1
 template<typename T, typename U>
-// static variables in constepxr functions are allowed only from c++20
-#if __cplusplus >= 202002L
-constexpr
-#endif
-inline T GetDiff(U digit, U totalDigits);
+constexpr inline T GetDiff(U digit, U totalDigits);
 } // detail
 
 
@@ -150,7 +323,7 @@ inline T GetDiff(U digit, U totalDigits);
 template<typename Functor>
 constexpr void GetAllPalindromes(Functor callback)
 {
-	using ReturnType = typename FunctorTraits<Functor>::arg<0>::type;
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
 	ReturnType number = ReturnType(0);
 	callback(number);
 
@@ -162,13 +335,19 @@ constexpr void GetAllPalindromes(Functor callback)
         number = 0;
 	}
 
-	detail::IteratePalindromesRanging(number, std::numeric_limits<ReturnType>::digits10 + 1, std::numeric_limits<ReturnType>::digits10 + 1, GetValidRangesFromNumber(std::numeric_limits<ReturnType>::max()), callback);
+	// Only some of the longest palindromes fit, they are enumerated block by block
+	const uint32_t maxDigits = std::numeric_limits<ReturnType>::digits10 + 1;
+	for(const std::vector<DigitRange> &validRanges : detail::GetValidRangeBlocksUpTo(std::numeric_limits<ReturnType>::max()))
+	{
+		detail::IteratePalindromesRanging(number, maxDigits, maxDigits, validRanges, callback);
+		number = 0;
+	}
 }
 
 template<typename T, typename Functor>
 constexpr void GetPalindromesDigitCountRange(const DigitCountRange<T> &digitCountRange, Functor callback)
 {
-    using ReturnType = typename FunctorTraits<Functor>::arg<0>::type;
+    using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
     ReturnType number = ReturnType(0);
 	if(digitCountRange.min < 2 && 1 < digitCountRange.max)
 		callback(number);
@@ -177,7 +356,8 @@ constexpr void GetPalindromesDigitCountRange(const DigitCountRange<T> &digitCoun
     if(std::numeric_limits<ReturnType>::is_specialized && std::numeric_limits<ReturnType>::digits10 < digitCountRange.max)
         std::cout << "Number might overflow"; // TODO: Use logger
     
-    for(T digit = digitCountRange.min; digit < digitCountRange.max; digit = digit + T(1))
+    // 0 is passed above, it has no digits
+    for(T digit = std::max(digitCountRange.min, T(1)); digit < digitCountRange.max; digit = digit + T(1))
     {
         detail::IteratePalindromes(number, digit, digit, callback);
         number = 0;
@@ -187,63 +367,246 @@ constexpr void GetPalindromesDigitCountRange(const DigitCountRange<T> &digitCoun
 template<typename Functor>
 constexpr void GetPalindromesDigitRange(const std::vector<DigitRange> &ranges, Functor callback)
 {
-	using ReturnType = typename FunctorTraits<Functor>::arg<0>::type;
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
 	ReturnType number = ReturnType(0);
-	if(ranges.size() == 1)
+	// 0 is the only 1-digit number whose most significant digit can be 0
+	if(ranges.size() == 1 && ranges[0].min == 0 && 0 < ranges[0].max)
 		callback(number);
 
-	detail::IteratePalindromesRanging(number, ranges.size(), ranges.size(), detail::GetValidRanges(ranges), callback);
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	if(detail::HasValidDigits(validRanges))
+		detail::IteratePalindromesRanging(number, ranges.size(), ranges.size(), validRanges, callback);
+}
+
+template<typename T, typename Functor>
+void GetAllPalindromes(T *buffer, std::size_t bufferSize, Functor callback)
+{
+	static_assert(std::numeric_limits<T>::is_specialized, "Need to know std::numeric_limits<T> in order to get all palindromes from this type");
+	assert(bufferSize != 0 && "Buffer must hold at least one palindrome");
+
+	detail::PalindromeBlockWriter<T, Functor> writer(buffer, bufferSize, callback);
+	writer(T(0), T(0), 1);
+	const DefUIntType maxDigits = std::numeric_limits<T>::digits10 + 1;
+	for(DefUIntType digit = 1; digit < maxDigits; digit++)
+		detail::IteratePalindromeRuns(T(0), digit, digit, nullptr, writer);
+	// Only some of the longest palindromes fit, see GetAllPalindromes(callback)
+	for(const std::vector<DigitRange> &validRanges : detail::GetValidRangeBlocksUpTo(std::numeric_limits<T>::max()))
+		detail::IteratePalindromeRuns(T(0), maxDigits, maxDigits, &validRanges, writer);
+	writer.Flush();
+}
+
+template<typename T, typename U, typename Functor>
+void GetPalindromesDigitCountRange(const DigitCountRange<U> &digitCountRange, T *buffer, std::size_t bufferSize, Functor callback)
+{
+	assert(bufferSize != 0 && "Buffer must hold at least one palindrome");
+	detail::PalindromeBlockWriter<T, Functor> writer(buffer, bufferSize, callback);
+	if(digitCountRange.min < 2 && 1 < digitCountRange.max)
+		writer(T(0), T(0), 1);
+	for(U digit = std::max(digitCountRange.min, U(1)); digit < digitCountRange.max; digit = digit + U(1))
+		detail::IteratePalindromeRuns(T(0), static_cast<DefUIntType>(digit), static_cast<DefUIntType>(digit), nullptr, writer);
+	writer.Flush();
+}
+
+template<typename T, typename Functor>
+void GetPalindromesDigitRange(const std::vector<DigitRange> &ranges, T *buffer, std::size_t bufferSize, Functor callback)
+{
+	assert(bufferSize != 0 && "Buffer must hold at least one palindrome");
+	detail::PalindromeBlockWriter<T, Functor> writer(buffer, bufferSize, callback);
+	if(ranges.size() == 1 && ranges[0].min == 0 && 0 < ranges[0].max)
+		writer(T(0), T(0), 1);
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	if(!validRanges.empty())
+		detail::IteratePalindromeRuns(T(0), ranges.size(), ranges.size(), &validRanges, writer);
+	writer.Flush();
 }
 
 template <typename T>
 constexpr bool IsPalindrome(T number)
 {
-	if(number < T(0))
-		return IsPalindrome(-number);
+	// Decompose number once instead of dividing it for every digit
+	// Custom integer types (like BigUInt) are decomposed too, their digit count is known from std::numeric_limits
+	if constexpr(std::is_integral_v<T> || kIsInteger<T> || std::numeric_limits<T>::is_integer)
+		return IsPalindrome(DigitView<T>(number));
+	else
+	{
+		if(number < T(0))
+			return IsPalindrome(-number);
 
-	if(number == T(0))
-		return true;
+		if(number == T(0))
+			return true;
 
-	T reversed = T(0);
-	const DefUIntType digits = DigitCount(number);
-	const DefUIntType halfDigits = (digits - 1) / 2;
+		T reversed = T(0);
+		const DefUIntType digits = DigitCount(number);
+		const DefUIntType halfDigits = (digits - 1) / 2;
 
-	for(int i = halfDigits; i >= 0; i--)
-		reversed = reversed + GetDigit(number, i) * FastPower10(halfDigits - i);
+		for(int i = halfDigits; i >= 0; i--)
+			reversed = reversed + GetDigit(number, i) * FastPower10(halfDigits - i);
 
-	if constexpr(std::is_integral_v<T>)
-		return (number / FastPower10(digits / 2)) == reversed;
+		T result = number - reversed;
+		return result < T(1);
+	}
+}
 
-	T result = number - reversed;
-	return result < T(1);
+template<typename T>
+constexpr bool IsPalindrome(const DigitView<T> &view)
+{
+	// Zero padded digit words are reversed with byte swap
+	// Reversed digits are shifted by padding size, so that they line up with original ones
+	// Fixed amount of word operations, so there is no branch on digit count
+	constexpr std::size_t kWords = DigitView<T>::kWordCount;
+	// Zero words after reversed digits, so that shifted reads don't need bound checks
+	uint64_t reversed[kWords * 2 + 1] = {};
+	for(std::size_t i = 0; i < kWords; i++)
+		reversed[kWords - 1 - i] = __builtin_bswap64(view.GetDigitWord(i));
+
+	const DefUIntType shift = kWords * 8 - view.GetDigitCount();
+	const DefUIntType wordShift = shift / 8;
+	const DefUIntType bitShift = shift % 8 * 8;
+	uint64_t mismatch = 0;
+	for(std::size_t i = 0; i < kWords; i++)
+	{
+		// Shift in two steps, because shift by 64 is undefined
+		const uint64_t aligned = (reversed[i + wordShift] >> bitShift) | ((reversed[i + wordShift + 1] << 1) << (63 - bitShift));
+		mismatch |= view.GetDigitWord(i) ^ aligned;
+	}
+	return mismatch == 0;
 }
 
 template <typename T, typename U>
 constexpr U GetIndexOfPalindrome(const T palindrome)
 {
-	if(!IsPalindrome(palindrome))
-		return U(-1);
+	return GetIndexOfPalindrome<U>(DigitView<T>(palindrome));
+}
 
-    const U result = U(0);
-	const DefUIntType halfDigits = (DigitCount(palindrome) + 1) / 2 - 1;
-	for(DefUIntType i = halfDigits; i >= 0; i--)
-	{
-		if(i > halfDigits - 1)
-		{
-			result = result + GetDigit(palindrome, i);
-			continue;
-		}
+template<typename U, typename T>
+constexpr U GetIndexOfPalindrome(const DigitView<T> &view)
+{
+	const DefUIntType digits = view.GetDigitCount();
+	if(digits == 0 || view.IsNegative() || !IsPalindrome(view))
+		return U(0);
+
+	// All palindromes with less digits go first
+	U result = U(0);
+	for(DefUIntType i = 1; i < digits; i++)
+		result = result + GetPalindromeCountInNDigitNumber<U>(i);
+
+	// Then position of upper half among halves with the same digit count, that start from 10^(halfDigits - 1)
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	U half = U(0);
+	for(DefUIntType i = digits; digits - halfDigits < i; i--)
+		half = half * U(10) + U(view[i - 1]);
+
+	return result + half - FastPower10<U>(halfDigits - 1) + U(1);
+}
+
+template<typename T, typename U>
+constexpr T GetPalindromeWithIndex(U index)
+{
+	if(index < U(1))
+		return T(0);
 
-		result = result + (GetDigit(palindrome, i) - 1) * GetPalindromeCountInNDigitNumber(i - halfDigits - 2);
+	// Skip palindromes with less digits
+	// Count that doesn't fit into U is bigger than any index, so loop stops before it
+	DefUIntType digits = 1;
+	while(static_cast<int>((digits - 1) / 2) + 1 < kMaxDigits<U>)
+	{
+		const U count = GetPalindromeCountInNDigitNumber<U>(digits);
+		if(index <= count)
+			break;
+		index = index - count;
+		digits++;
 	}
+	if(kMaxDigits<T> < static_cast<int>(digits))
+		return T(0);
+
+	// Upper halves with the same digit count go one by one from 10^(halfDigits - 1)
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	return detail::MirrorUpperHalf<T>(FastPower10<T>(halfDigits - 1) + static_cast<T>(index - U(1)), digits);
+}
+
+template<typename T>
+constexpr T NextPalindrome(T number)
+{
+	if(number <= T(0))
+		return T(0);
 
-	return result;
+	// Palindrome of upper half if it isn't less than number, otherwise palindrome of the next upper half
+	// Upper half can't be 99..9 then, its palindrome is the biggest number with this digit count, so there is no carry into next digit count
+	const DefUIntType digits = DigitCount(number);
+	const T half = DividePower10(number, digits / 2);
+	const T lower = detail::ReverseUpperHalf<T>(half, digits);
+	if(number - half * FastPower10<T>(digits / 2) <= lower)
+		return detail::JoinHalves<T>(half, lower, digits);
+	return detail::MirrorUpperHalf<T>(half + T(1), digits);
+}
+
+template<typename T>
+constexpr T PrevPalindrome(T number)
+{
+	if(number <= T(0))
+		return T(0);
+
+	const DefUIntType digits = DigitCount(number);
+	const T half = DividePower10(number, digits / 2);
+	const T lower = detail::ReverseUpperHalf<T>(half, digits);
+	if(lower <= number - half * FastPower10<T>(digits / 2))
+		return detail::JoinHalves<T>(half, lower, digits);
+	// Only 10..0 is below palindrome of its upper half 10..01 and borrows from previous digit count
+	if(half == FastPower10<T>((digits - 1) / 2))
+		return FastPower10<T>(digits - 1) - T(1);
+	return detail::MirrorUpperHalf<T>(half - T(1), digits);
+}
+
+template<typename T>
+void NextPalindrome(const T *in, T *out, std::size_t count)
+{
+	for(std::size_t i = 0; i < count; i++)
+		out[i] = NextPalindrome(in[i]);
+}
+
+template<typename T>
+void PrevPalindrome(const T *in, T *out, std::size_t count)
+{
+	for(std::size_t i = 0; i < count; i++)
+		out[i] = PrevPalindrome(in[i]);
+}
+
+template<typename R, typename T, typename U>
+constexpr R CountPalindromes(T min, U max)
+{
+	const R upToMax = detail::CountPalindromesUpTo<R>(max);
+	const R belowMin = min <= T(0) ? R(0) : detail::CountPalindromesUpTo<R>(min - T(1));
+	// Empty interval for min > max
+	return belowMin < upToMax ? upToMax - belowMin : R(0);
+}
+
+template<typename R>
+#if __cplusplus >= 202002L
+constexpr
+#endif
+R CountPalindromes(const std::vector<DigitRange> &ranges)
+{
+	if(ranges.empty())
+		return R(0);
+
+	// Every position of upper half is independent, so count is the product of valid digit counts
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	R count = R(1);
+	for(std::size_t i = 0; i < validRanges.size(); i++)
+	{
+		// The most significant digit can't be 0, unless number is 0 itself
+		const uint8_t min = i == 0 && 1 < ranges.size() ? std::max<uint8_t>(1, validRanges[i].min) : validRanges[i].min;
+		if(validRanges[i].max <= min)
+			return R(0);
+		count = count * R(validRanges[i].max - min);
+	}
+	return count;
 }
 
 template<typename Functor>
 constexpr void GetPalindromesFromValidRanges(const std::vector<DigitRange> &ranges, bool odd, Functor &&callback)
 {
-	using ReturnType = typename FunctorTraits<Functor>::arg<0>::type;
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
 	ReturnType number = ReturnType(0);
 	if(ranges.size() == 1 && odd)
 		callback(number);
@@ -301,6 +664,97 @@ auto GetValidRanges(const std::vector<DigitRange> &ranges) -> std::vector<DigitR
 	return validRanges;
 }
 
+template<typename T>
+#if __cplusplus >= 202002L
+constexpr
+#endif
+auto GetValidRangeBlocksUpTo(T max) -> std::vector<std::vector<DigitRange>>
+{
+	const std::size_t n = DigitCount(max);
+	const std::size_t halfDigits = (n + 1) / 2;
+	std::vector<DigitRange> validRanges(halfDigits, DigitRange(0, 10));
+	std::vector<std::vector<DigitRange>> blocks;
+
+	for(std::size_t i = 0; i < halfDigits; i++)
+	{
+		const uint8_t digit = static_cast<uint8_t>(GetDigit(max, n - i - 1));
+		// The most significant digit can't be 0, so the first block is empty for leading 1
+		if((i == 0 ? 1 : 0) < digit)
+		{
+			blocks.push_back(validRanges);
+			blocks.back()[i] = DigitRange(0, digit);
+		}
+		validRanges[i] = DigitRange(digit, digit + 1);
+	}
+
+	if(CompareUpperHalfPalindrome(max) <= 0)
+		blocks.push_back(validRanges);
+	return blocks;
+}
+
+template<typename T>
+constexpr int CompareUpperHalfPalindrome(T number)
+{
+	// Palindrome and number share upper half, so only lower halves are compared
+	const DefUIntType digits = DigitCount(number);
+	const T half = DividePower10(number, digits / 2);
+	const T mirrored = ReverseUpperHalf(half, digits);
+	const T lower = number - half * FastPower10<T>(digits / 2);
+	return mirrored < lower ? -1 : (lower < mirrored ? 1 : 0);
+}
+
+template<typename T>
+constexpr T ReverseUpperHalf(T half, DefUIntType digits)
+{
+	// Division by constant 10 is multiplication, so this is cheaper than taking digits with GetDigit
+	// Middle digit of odd palindrome is only in upper half
+	T lower = T(0);
+	for(T rest = digits % 2 == 0 ? half : half / T(10); T(0) < rest; rest = rest / T(10))
+		lower = lower * T(10) + rest % T(10);
+	return lower;
+}
+
+template<typename T>
+constexpr T JoinHalves(T half, T lower, DefUIntType digits)
+{
+	const T scale = FastPower10<T>(digits / 2);
+	// Only some of the longest palindromes fit
+	if(static_cast<int>(digits) == kMaxDigits<T> && (std::numeric_limits<T>::max() - lower) / scale < half)
+		return T(0);
+	return half * scale + lower;
+}
+
+template<typename R, typename T>
+constexpr R CountPalindromesUpTo(T max)
+{
+	if(max < T(0))
+		return R(0);
+
+	// 0 and all palindromes with less digits
+	const DefUIntType n = DigitCount(max);
+	R count = R(1);
+	for(DefUIntType i = 1; i < n; i++)
+		count = count + GetPalindromeCountInNDigitNumber<R>(i);
+	if(n == 0)
+		return count;
+
+	// Upper halves from 10^(halfDigits - 1) below upper half of max, and upper half of max itself if its palindrome fits
+	const DefUIntType halfDigits = (n + 1) / 2;
+	const T half = DividePower10(max, n - halfDigits);
+	return count + static_cast<R>(half) - FastPower10<R>(halfDigits - 1) + R(CompareUpperHalfPalindrome(max) <= 0 ? 1 : 0);
+}
+
+#if __cplusplus >= 202002L
+constexpr
+#endif
+bool HasValidDigits(const std::vector<DigitRange> &validRanges)
+{
+	for(std::size_t i = 0; i < validRanges.size(); i++)
+		if(validRanges[i].max <= (i == 0 ? std::max<uint8_t>(1, validRanges[i].min) : validRanges[i].min))
+			return false;
+	return !validRanges.empty();
+}
+
 
 template<typename ReturnType, typename U, typename Functor>
 constexpr void IteratePalindromes(ReturnType &number, U digit, U totalDigits, Functor callback)
@@ -331,6 +785,51 @@ constexpr void IteratePalindromes(ReturnType &number, U digit, U totalDigits, Fu
     number = number - diff * ReturnType(9);
 }
 
+template<typename T, typename Run>
+void IteratePalindromeRuns(T number, DefUIntType digit, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges, Run &run)
+{
+	const DigitRange range = GetDigitPairRange(digit, totalDigits, validRanges);
+	if(range.max <= range.min)
+		return;
+
+	const T diff = GetDiff<T>(digit, totalDigits);
+	if(digit <= 2)
+	{
+		run(static_cast<T>(number + diff * T(range.min)), diff, range.max - range.min);
+		return;
+	}
+	for(uint8_t i = range.min; i < range.max; i++)
+		IteratePalindromeRuns(static_cast<T>(number + diff * T(i)), digit - 2, totalDigits, validRanges, run);
+}
+
+template<typename T, typename Functor>
+void PalindromeBlockWriter<T, Functor>::operator()(T first, T diff, std::size_t count)
+{
+	while(count != 0)
+	{
+		// Run is split only on block boundary, inside of it there is no check per palindrome
+		const std::size_t n = std::min(count, m_bufferSize - m_size);
+		T *out = m_buffer + m_size;
+		for(std::size_t i = 0; i < n; i++)
+			out[i] = static_cast<T>(first + diff * T(i));
+		m_size += n;
+		count -= n;
+		if(m_size == m_bufferSize)
+			Flush();
+		// Only palindromes are computed, so that signed T doesn't overflow after the last one
+		if(count != 0)
+			first = static_cast<T>(first + diff * T(n));
+	}
+}
+
+template<typename T, typename Functor>
+void PalindromeBlockWriter<T, Functor>::Flush()
+{
+	if(m_size != 0)
+		m_callback(static_cast<const T *>(m_buffer), m_size);
+	m_size = 0;
+}
+
 template<typename ReturnType, typename U, typename Functor>
 constexpr void IteratePalindromesRanging(ReturnType &number, U digit, U totalDigits, const std::vector<DigitRange> &validRanges, Functor callback)
 {
@@ -338,12 +837,11 @@ constexpr void IteratePalindromesRanging(ReturnType &number, U digit, U totalDig
 
     ReturnType diff = GetDiff<ReturnType>(digit, totalDigits);
 
-	if(digit == totalDigits)
-		number = number + diff * std::max<uint8_t>(1, validRange.min);
-	else
-		number = number + diff * validRange.min;
+	// The most significant digit can't be 0
+	const uint8_t first = digit == totalDigits ? std::max<uint8_t>(1, validRange.min) : validRange.min;
+	number = number + diff * first;
 
-	for(uint8_t i = validRange.min + 1 + (digit == totalDigits); i < validRange.max; i++)
+	for(uint8_t i = first + 1; i < validRange.max; i++)
 	{
 		if(U(2) < digit)
 		{
@@ -366,15 +864,18 @@ constexpr void IteratePalindromesRanging(ReturnType &number, U digit, U totalDig
 
 
 template<typename T, typename U>
-#if __cplusplus >= 202002L
-constexpr
-#endif
-T GetDiff(U digit, U totalDigits)
+constexpr T GetDiff(U digit, U totalDigits)
 {
+	// Lookup has only 21 entries and can't hold custom types, so other differences are computed
+	// kGetDiffLookup<T>[digit] = 10^(digit - 1) + 1, except for 1 digit
 	if constexpr(!std::is_arithmetic_v<T>)
-        return (FastPower10(digit) + T(1)) * (totalDigits - digit) / U(2);
-
-    return kGetDiffLookup<T>[digit] * FastPower10((totalDigits - digit) / U(2));
+		return (digit == U(1) ? T(1) : FastPower10<T>(digit - U(1)) + T(1)) * FastPower10<T>((totalDigits - digit) / U(2));
+	else
+	{
+		if(U(std::size(kGetDiffLookup<T>)) <= digit)
+			return (FastPower10<T>(digit - U(1)) + T(1)) * FastPower10<T>((totalDigits - digit) / U(2));
+		return kGetDiffLookup<T>[digit] * FastPower10<T>((totalDigits - digit) / U(2));
+	}
 }
 } // detail
 } // palindrome
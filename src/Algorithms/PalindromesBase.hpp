@@ -0,0 +1,418 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROMES_BASE_HPP
+#define TOLIK_ALGORITHMS_PALINDROMES_BASE_HPP
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Type.hpp"
+
+// Palindromes in any base from 2 to 36, base is the first template argument: IsPalindrome<2>(9) = true (1001)
+// Functions overload the base 10 ones from Palindromes.hpp, calls without base aren't affected by them
+// Digits of bases 2, 4 and 16 are whole bit groups, so up to 64-bit numbers are checked and mirrored with byte swap
+// and mask shuffles instead of division, other bases divide by constant Base. IsPalindrome<10> is the same as IsPalindrome
+// Example: GetDoubleBasePalindromes<10, 2>(1000u, callback) = 0 1 3 5 7 9 33 99 313 585 717
+
+#ifdef __has_builtin
+#if __has_builtin(__builtin_bitreverse64)
+#define TOLIK_HAS_BITREVERSE
+#endif
+#endif
+
+namespace Tolik
+{
+namespace palindrome
+{
+// Count of digits in base Base, 0 = 0 digits
+// Sign is ignored
+template<DefUIntType Base, typename T>
+constexpr DefUIntType DigitCountInBase(T number);
+
+// Checks if number reads the same in base Base both ways
+// Sign is ignored, the same as in IsPalindrome(number)
+// Example: IsPalindrome<2>(9) = true (1001); IsPalindrome<16>(0x1221) = true; IsPalindrome<2>(6) = false (110)
+template<DefUIntType Base, typename T>
+constexpr bool IsPalindrome(T number);
+
+// Count of palindromes with exactly numberDigits digits in base Base (0 isn't counted)
+// Example: <2>(4) = 2 (1001 1111); <16>(3) = 240
+template<DefUIntType Base, typename T = DefUIntType>
+constexpr T GetPalindromeCountInNDigitNumber(DefUIntType numberDigits);
+
+// Position of palindrome among all positive palindromes in base Base in ascending order, starts with 1
+// 0 is returned if number isn't palindrome in this base or isn't positive
+// Example: <2>(9) = 5 (1 11 101 111 1001)
+template<DefUIntType Base, typename T, typename U = DefIntType>
+constexpr U GetIndexOfPalindrome(T palindrome);
+
+// Inverse of GetIndexOfPalindrome<Base>, 0 if index is 0 or palindrome doesn't fit into T
+template<DefUIntType Base, typename T = DefIntType, typename U>
+constexpr T GetPalindromeWithIndex(U index);
+
+// Count of palindromes in base Base in [min, max], both inclusive, without enumerating them
+template<DefUIntType Base, typename R = std::size_t, typename T, typename U>
+constexpr R CountPalindromes(T min, U max);
+
+// All palindromes in base Base in [0, max] in ascending order, callback(T number)
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void GetPalindromesUpTo(T max, Functor callback);
+
+// All palindromes in base Base that fit into callback argument type
+template<DefUIntType Base, typename Functor>
+constexpr void GetAllPalindromes(Functor callback);
+
+// Palindromes with digit count in base Base in range, first - inclusive, second - exclusive
+// Digit counts that don't fit into callback argument type are cut off, and only fitting palindromes of the longest one are passed
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void GetPalindromesDigitCountRange(const DigitCountRange<T> &digitCountRange, Functor callback);
+
+// Numbers in [0, max] that are palindromes in both bases, in ascending order
+// Palindromes of BaseA are enumerated and checked in BaseB, checks in bases 2, 4 and 16 are the cheapest
+// Example: <10, 2>(1000) = 0 1 3 5 7 9 33 99 313 585 717
+template<DefUIntType BaseA, DefUIntType BaseB, typename T, typename Functor>
+constexpr void GetDoubleBasePalindromes(T max, Functor callback);
+
+namespace detail
+{
+template<typename T, DefUIntType Base>
+constexpr inline DefUIntType MakeMaxDigitsInBase()
+{
+	DefUIntType digits = 0;
+	for(T rest = std::numeric_limits<T>::max(); T(0) < rest; rest = rest / T(Base))
+		digits++;
+	return digits;
+}
+
+// Digit count of the biggest value of T in base Base
+template<typename T, DefUIntType Base>
+constexpr inline DefUIntType kMaxDigitsInBase = MakeMaxDigitsInBase<T, Base>();
+
+// powers[i] = Base^i for every i that fits into T
+template<typename T, DefUIntType Base>
+constexpr inline std::array<T, kMaxDigitsInBase<T, Base>> MakePowersInBase()
+{
+	std::array<T, kMaxDigitsInBase<T, Base>> powers{};
+	T power = T(1);
+	for(std::size_t i = 0; i < powers.size(); i++)
+	{
+		powers[i] = power;
+		if(i + 1 < powers.size())
+			power = static_cast<T>(power * T(Base));
+	}
+	return powers;
+}
+
+template<typename T, DefUIntType Base>
+constexpr inline std::array<T, kMaxDigitsInBase<T, Base>> kPowersInBase = MakePowersInBase<T, Base>();
+
+// Bits per digit for bases whose digits split bytes evenly, 0 for the rest
+template<DefUIntType Base>
+constexpr inline DefUIntType kBitsPerDigit = Base == 2 ? 1 : (Base == 4 ? 2 : (Base == 16 ? 4 : 0));
+
+// Digits are handled as bit groups of one 64-bit word
+template<DefUIntType Base, typename T>
+constexpr inline bool kUseBitReversal = kBitsPerDigit<Base> != 0 && kIsInteger<T> && sizeof(T) <= sizeof(uint64_t);
+
+// Order of Bits wide groups is reversed, bits inside group stay in place
+// Byte swap reverses bytes, then halves of smaller and smaller parts are swapped down to group size
+// Example: <4>(0x12...) = 0x...21
+template<DefUIntType Bits>
+constexpr inline uint64_t ReverseBitGroups(uint64_t value)
+{
+#ifdef TOLIK_HAS_BITREVERSE
+	// Single rbit on ARM
+	if constexpr(Bits == 1)
+		return __builtin_bitreverse64(value);
+#endif
+	value = __builtin_bswap64(value);
+	if constexpr(Bits <= 4)
+		value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+	if constexpr(Bits <= 2)
+		value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+	if constexpr(Bits <= 1)
+		value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+	return value;
+}
+
+// Lower half of palindrome with digits digits in base Base and given upper half, see ReverseUpperHalf
+template<DefUIntType Base, typename T>
+constexpr T ReverseUpperHalfInBase(T half, DefUIntType digits);
+
+// Palindrome with digits digits in base Base and given upper half, 0 if it doesn't fit into T
+template<DefUIntType Base, typename T>
+constexpr T MirrorUpperHalfInBase(T half, DefUIntType digits);
+
+// Count of palindromes with the same digit count as max in base Base that are not bigger than max
+template<DefUIntType Base, typename T>
+constexpr T CountPalindromesWithDigitsUpTo(T max, DefUIntType digits);
+
+// Passes the first count palindromes with digits digits in base Base in ascending order
+// Upper half is kept as digit odometer, number changes by the difference of incremented digit pair
+// It is faster than mirroring every upper half even for bit group bases
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void IteratePalindromesInBase(DefUIntType digits, T count, Functor &callback);
+} // detail
+
+
+
+template<DefUIntType Base, typename T>
+constexpr DefUIntType DigitCountInBase(T number)
+{
+	static_assert(2 <= Base && Base <= 36, "Base must be from 2 to 36");
+
+	using UnsignedT = MakeUnsignedT<T>;
+	const UnsignedT magnitude = Tolik::detail::UnsignedAbs(number);
+	if constexpr(Base == 10)
+		return DigitCount(magnitude);
+	else if constexpr(detail::kBitsPerDigit<Base> != 0)
+		return magnitude == UnsignedT(0) ? 0 : (Tolik::detail::BitWidth(magnitude) + detail::kBitsPerDigit<Base> - 1) / detail::kBitsPerDigit<Base>;
+	else
+	{
+		constexpr auto &powers = detail::kPowersInBase<UnsignedT, Base>;
+		DefUIntType digits = 0;
+		while(digits < powers.size() && powers[digits] <= magnitude)
+			digits++;
+		return digits;
+	}
+}
+
+template<DefUIntType Base, typename T>
+constexpr bool IsPalindrome(T number)
+{
+	static_assert(2 <= Base && Base <= 36, "Base must be from 2 to 36");
+
+	if constexpr(Base == 10)
+		return IsPalindrome(number);
+	else if constexpr(detail::kUseBitReversal<Base, T>)
+	{
+		// Reversed groups are shifted down by unused high bits
+		const uint64_t magnitude = static_cast<uint64_t>(Tolik::detail::UnsignedAbs(number));
+		if(magnitude == 0)
+			return true;
+		const DefUIntType bits = DigitCountInBase<Base>(magnitude) * detail::kBitsPerDigit<Base>;
+		return (detail::ReverseBitGroups<detail::kBitsPerDigit<Base>>(magnitude) >> (64 - bits)) == magnitude;
+	}
+	else
+	{
+		// Lower half of digits is reversed until it reaches upper half, so reversed number can't overflow
+		// Number with trailing zero passes this check, but it isn't palindrome (except 0)
+		using UnsignedT = MakeUnsignedT<T>;
+		UnsignedT upper = Tolik::detail::UnsignedAbs(number);
+		if(upper % UnsignedT(Base) == UnsignedT(0) && upper != UnsignedT(0))
+			return false;
+
+		UnsignedT reversed = UnsignedT(0);
+		while(reversed < upper)
+		{
+			reversed = reversed * UnsignedT(Base) + upper % UnsignedT(Base);
+			upper = upper / UnsignedT(Base);
+		}
+		return upper == reversed || upper == reversed / UnsignedT(Base);
+	}
+}
+
+template<DefUIntType Base, typename T>
+constexpr T GetPalindromeCountInNDigitNumber(DefUIntType numberDigits)
+{
+	static_assert(2 <= Base && Base <= 36, "Base must be from 2 to 36");
+	return numberDigits == 0 ? T(0) : T(Base - 1) * IntegralPower(T(Base), (numberDigits - 1) / 2);
+}
+
+template<DefUIntType Base, typename T, typename U>
+constexpr U GetIndexOfPalindrome(T palindrome)
+{
+	if(palindrome <= T(0) || !IsPalindrome<Base>(palindrome))
+		return U(0);
+
+	// All palindromes with less digits go first, then position of upper half among halves with the same digit count
+	const DefUIntType digits = DigitCountInBase<Base>(palindrome);
+	U result = U(0);
+	for(DefUIntType i = 1; i < digits; i++)
+		result = result + GetPalindromeCountInNDigitNumber<Base, U>(i);
+
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	const T half = palindrome / detail::kPowersInBase<T, Base>[digits / 2];
+	return result + static_cast<U>(half - detail::kPowersInBase<T, Base>[halfDigits - 1]) + U(1);
+}
+
+template<DefUIntType Base, typename T, typename U>
+constexpr T GetPalindromeWithIndex(U index)
+{
+	if(index < U(1))
+		return T(0);
+
+	// Count that doesn't fit into U is bigger than any index, so loop stops before it
+	DefUIntType digits = 1;
+	while((digits - 1) / 2 + 1 < detail::kMaxDigitsInBase<U, Base>)
+	{
+		const U count = GetPalindromeCountInNDigitNumber<Base, U>(digits);
+		if(index <= count)
+			break;
+		index = index - count;
+		digits++;
+	}
+	if(detail::kMaxDigitsInBase<T, Base> < digits)
+		return T(0);
+
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	return detail::MirrorUpperHalfInBase<Base, T>(detail::kPowersInBase<T, Base>[halfDigits - 1] + static_cast<T>(index - U(1)), digits);
+}
+
+template<DefUIntType Base, typename R, typename T, typename U>
+constexpr R CountPalindromes(T min, U max)
+{
+	// 0 and all palindromes with less digits than max, then ones with the same digit count
+	const auto countUpTo = [](auto number)
+	{
+		using V = decltype(number);
+		if(number < V(0))
+			return R(0);
+		const DefUIntType digits = DigitCountInBase<Base>(number);
+		R count = R(1);
+		for(DefUIntType i = 1; i < digits; i++)
+			count = count + GetPalindromeCountInNDigitNumber<Base, R>(i);
+		return digits == 0 ? count : count + static_cast<R>(detail::CountPalindromesWithDigitsUpTo<Base>(number, digits));
+	};
+
+	const R upToMax = countUpTo(max);
+	const R belowMin = min <= T(0) ? R(0) : countUpTo(min - T(1));
+	return belowMin < upToMax ? upToMax - belowMin : R(0);
+}
+
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void GetPalindromesUpTo(T max, Functor callback)
+{
+	if(max < T(0))
+		return;
+
+	callback(T(0));
+	const DefUIntType maxDigits = DigitCountInBase<Base>(max);
+	for(DefUIntType digits = 1; digits < maxDigits; digits++)
+		detail::IteratePalindromesInBase<Base>(digits, GetPalindromeCountInNDigitNumber<Base, T>(digits), callback);
+	if(maxDigits != 0)
+		detail::IteratePalindromesInBase<Base>(maxDigits, detail::CountPalindromesWithDigitsUpTo<Base>(max, maxDigits), callback);
+}
+
+template<DefUIntType Base, typename Functor>
+constexpr void GetAllPalindromes(Functor callback)
+{
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
+	static_assert(std::numeric_limits<ReturnType>::is_specialized, "Need to know std::numeric_limits<T> in order to get all palindromes from this type");
+	GetPalindromesUpTo<Base>(std::numeric_limits<ReturnType>::max(), callback);
+}
+
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void GetPalindromesDigitCountRange(const DigitCountRange<T> &digitCountRange, Functor callback)
+{
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
+	constexpr DefUIntType kMaxDigits = detail::kMaxDigitsInBase<ReturnType, Base>;
+	if(digitCountRange.min < T(2) && T(1) < digitCountRange.max)
+		callback(ReturnType(0));
+
+	const DefUIntType end = static_cast<DefUIntType>(std::clamp(digitCountRange.max, T(1), T(kMaxDigits + 1)));
+	for(DefUIntType digits = static_cast<DefUIntType>(std::clamp(digitCountRange.min, T(1), T(end))); digits < end; digits++)
+	{
+		const ReturnType count = digits == kMaxDigits ?
+			detail::CountPalindromesWithDigitsUpTo<Base>(std::numeric_limits<ReturnType>::max(), digits) :
+			GetPalindromeCountInNDigitNumber<Base, ReturnType>(digits);
+		detail::IteratePalindromesInBase<Base>(digits, count, callback);
+	}
+}
+
+template<DefUIntType BaseA, DefUIntType BaseB, typename T, typename Functor>
+constexpr void GetDoubleBasePalindromes(T max, Functor callback)
+{
+	GetPalindromesUpTo<BaseA>(max, [&](T number)
+	{
+		if(IsPalindrome<BaseB>(number))
+			callback(number);
+	});
+}
+
+
+namespace detail
+{
+template<DefUIntType Base, typename T>
+constexpr T ReverseUpperHalfInBase(T half, DefUIntType digits)
+{
+	// Middle digit of odd palindrome is only in upper half
+	if constexpr(kUseBitReversal<Base, T>)
+	{
+		const DefUIntType lowerBits = digits / 2 * kBitsPerDigit<Base>;
+		const uint64_t rest = static_cast<uint64_t>(half) >> (digits % 2 * kBitsPerDigit<Base>);
+		return lowerBits == 0 ? T(0) : static_cast<T>(ReverseBitGroups<kBitsPerDigit<Base>>(rest) >> (64 - lowerBits));
+	}
+	else
+	{
+		T lower = T(0);
+		for(T rest = digits % 2 == 0 ? half : half / T(Base); T(0) < rest; rest = rest / T(Base))
+			lower = lower * T(Base) + rest % T(Base);
+		return lower;
+	}
+}
+
+template<DefUIntType Base, typename T>
+constexpr T MirrorUpperHalfInBase(T half, DefUIntType digits)
+{
+	const T lower = ReverseUpperHalfInBase<Base>(half, digits);
+	const T scale = kPowersInBase<T, Base>[digits / 2];
+	// Only some of the longest palindromes fit
+	if(digits == kMaxDigitsInBase<T, Base> && (std::numeric_limits<T>::max() - lower) / scale < half)
+		return T(0);
+	return half * scale + lower;
+}
+
+template<DefUIntType Base, typename T>
+constexpr T CountPalindromesWithDigitsUpTo(T max, DefUIntType digits)
+{
+	// Upper halves from Base^(halfDigits - 1) below upper half of max, and upper half of max itself if its palindrome isn't bigger
+	// Palindrome and max share upper half, so only lower halves are compared
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	const T scale = kPowersInBase<T, Base>[digits / 2];
+	const T half = max / scale;
+	const T count = half - kPowersInBase<T, Base>[halfDigits - 1];
+	return ReverseUpperHalfInBase<Base>(half, digits) <= max % scale ? count + T(1) : count;
+}
+
+template<DefUIntType Base, typename T, typename Functor>
+constexpr void IteratePalindromesInBase(DefUIntType digits, T count, Functor &callback)
+{
+	if(count <= T(0))
+		return;
+
+	const DefUIntType halfDigits = (digits + 1) / 2;
+	// diffs[i] = Base^(digits - 1 - i) + Base^i is added when digit pair i (0 is the outer one) goes up by one
+	// Middle digit of odd palindrome is single, so it adds only Base^i
+	constexpr std::size_t kMaxHalfDigits = (kMaxDigitsInBase<T, Base> + 1) / 2;
+	std::array<uint8_t, kMaxHalfDigits> upper{};
+	std::array<T, kMaxHalfDigits> diffs{};
+	for(DefUIntType i = 0; i < halfDigits; i++)
+		diffs[i] = 2 * i + 1 == digits ? kPowersInBase<T, Base>[i] : static_cast<T>(kPowersInBase<T, Base>[digits - 1 - i] + kPowersInBase<T, Base>[i]);
+
+	// 10..01, or 1 for 1-digit palindrome
+	upper[0] = 1;
+	T number = diffs[0];
+	callback(number);
+	for(T i = T(1); i < count; i++)
+	{
+		DefUIntType pair = halfDigits - 1;
+		while(upper[pair] == Base - 1)
+		{
+			upper[pair] = 0;
+			number = number - diffs[pair] * T(Base - 1);
+			pair--;
+		}
+		upper[pair]++;
+		number = number + diffs[pair];
+		callback(number);
+	}
+}
+} // detail
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROMES_BASE_HPP
@@ -0,0 +1,243 @@
+#include "Algorithms/PalindromesBatch.hpp"
+
+#include <cstring>
+
+#include "Setup.hpp"
+#include "Math/BatchSimd.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Cpu.hpp"
+
+// Vector kernels don't decompose whole number, instead
+// lower half of digits is reversed into r until it reaches upper half x, then x == r (even digit count) or x == r / 10 (odd one)
+// Number with trailing zero (except 0) can't be palindrome, but it would pass this check, so it is excluded separately
+// Lanes that already reached the middle are masked, so there are at most half of the longest number steps
+// 64-bit division is expensive, so 64-bit kernels also stop as soon as every lane is done
+
+namespace Tolik
+{
+namespace palindrome
+{
+namespace detail
+{
+namespace
+{
+constexpr int kHalfSteps32 = 5;
+constexpr int kHalfSteps64 = 10;
+
+inline void SetMaskBits(uint64_t *mask, std::size_t index, uint64_t bits)
+{ mask[index / 64] |= bits << (index % 64); }
+
+// Also used for tails of vector kernels
+template<typename T>
+void GetPalindromeMaskScalar(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	for(std::size_t i = first; i < count; i++)
+		SetMaskBits(mask, i, IsPalindrome(in[i]));
+}
+
+
+#ifdef TOLIK_BATCH_X86
+using namespace Tolik::detail;
+
+// SSE4.2
+
+template<typename T>
+__attribute__((target("sse4.2"))) void GetPalindromeMask32SSE42(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	const __m128i tenMultiplier = _mm_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m128i ten = _mm_set1_epi32(10);
+	const __m128i zero = _mm_setzero_si128();
+	std::size_t i = first;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128i upper = LoadMagnitude32SSE42<kIsSignedInteger<T>>(in + i);
+		__m128i reversed = zero;
+		const __m128i lastZero = _mm_andnot_si128(_mm_cmpeq_epi32(upper, zero),
+			_mm_cmpeq_epi32(upper, _mm_mullo_epi32(_mm_srli_epi32(MulHiU32(upper, tenMultiplier), 3), ten)));
+		for(int step = 0; step < kHalfSteps32; step++)
+		{
+			const __m128i tenth = _mm_srli_epi32(MulHiU32(upper, tenMultiplier), 3);
+			const __m128i digit = _mm_sub_epi32(upper, _mm_mullo_epi32(tenth, ten));
+			const __m128i next = _mm_add_epi32(_mm_mullo_epi32(reversed, ten), digit);
+			// upper <= reversed
+			const __m128i done = _mm_cmpeq_epi32(_mm_max_epu32(upper, reversed), reversed);
+			upper = _mm_blendv_epi8(tenth, upper, done);
+			reversed = _mm_blendv_epi8(next, reversed, done);
+		}
+		const __m128i reversedTenth = _mm_srli_epi32(MulHiU32(reversed, tenMultiplier), 3);
+		const __m128i equal = _mm_or_si128(_mm_cmpeq_epi32(upper, reversed), _mm_cmpeq_epi32(upper, reversedTenth));
+		SetMaskBits(mask, i, static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(lastZero, equal)))));
+	}
+	GetPalindromeMaskScalar(in, mask, i, count);
+}
+
+
+// AVX2
+
+template<typename T>
+__attribute__((target("avx2"))) void GetPalindromeMask32AVX2(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	const __m256i tenMultiplier = _mm256_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m256i ten = _mm256_set1_epi32(10);
+	const __m256i zero = _mm256_setzero_si256();
+	std::size_t i = first;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m256i upper = LoadMagnitude32AVX2<kIsSignedInteger<T>>(in + i);
+		__m256i reversed = zero;
+		const __m256i lastZero = _mm256_andnot_si256(_mm256_cmpeq_epi32(upper, zero),
+			_mm256_cmpeq_epi32(upper, _mm256_mullo_epi32(_mm256_srli_epi32(MulHiU32AVX2(upper, tenMultiplier), 3), ten)));
+		for(int step = 0; step < kHalfSteps32; step++)
+		{
+			const __m256i tenth = _mm256_srli_epi32(MulHiU32AVX2(upper, tenMultiplier), 3);
+			const __m256i digit = _mm256_sub_epi32(upper, _mm256_mullo_epi32(tenth, ten));
+			const __m256i next = _mm256_add_epi32(_mm256_mullo_epi32(reversed, ten), digit);
+			const __m256i done = _mm256_cmpeq_epi32(_mm256_max_epu32(upper, reversed), reversed);
+			upper = _mm256_blendv_epi8(tenth, upper, done);
+			reversed = _mm256_blendv_epi8(next, reversed, done);
+		}
+		const __m256i reversedTenth = _mm256_srli_epi32(MulHiU32AVX2(reversed, tenMultiplier), 3);
+		const __m256i equal = _mm256_or_si256(_mm256_cmpeq_epi32(upper, reversed), _mm256_cmpeq_epi32(upper, reversedTenth));
+		SetMaskBits(mask, i, static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(lastZero, equal)))));
+	}
+	GetPalindromeMaskScalar(in, mask, i, count);
+}
+
+// AVX2 has no 64-bit mullo, so multiplication by 10 is two shifts
+__attribute__((target("avx2"))) inline __m256i Times10AVX2(__m256i value)
+{ return _mm256_add_epi64(_mm256_slli_epi64(value, 3), _mm256_slli_epi64(value, 1)); }
+
+template<typename T>
+__attribute__((target("avx2"))) void GetPalindromeMask64AVX2(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	const __m256i tenMultiplier = _mm256_set1_epi64x(static_cast<long long>(0xCCCCCCCCCCCCCCCDull));
+	const __m256i zero = _mm256_setzero_si256();
+	std::size_t i = first;
+	for(; i + 4 <= count; i += 4)
+	{
+		__m256i upper = LoadMagnitude64AVX2<kIsSignedInteger<T>>(in + i);
+		__m256i reversed = zero;
+		const __m256i lastZero = _mm256_andnot_si256(_mm256_cmpeq_epi64(upper, zero),
+			_mm256_cmpeq_epi64(upper, Times10AVX2(_mm256_srli_epi64(MulHiU64AVX2(upper, tenMultiplier), 3))));
+		for(int step = 0; step < kHalfSteps64; step++)
+		{
+			const __m256i tenth = _mm256_srli_epi64(MulHiU64AVX2(upper, tenMultiplier), 3);
+			const __m256i digit = _mm256_sub_epi64(upper, Times10AVX2(tenth));
+			const __m256i next = _mm256_add_epi64(Times10AVX2(reversed), digit);
+			const __m256i active = GreaterU64AVX2(upper, reversed);
+			if(_mm256_testz_si256(active, active))
+				break;
+			upper = _mm256_blendv_epi8(upper, tenth, active);
+			reversed = _mm256_blendv_epi8(reversed, next, active);
+		}
+		const __m256i reversedTenth = _mm256_srli_epi64(MulHiU64AVX2(reversed, tenMultiplier), 3);
+		const __m256i equal = _mm256_or_si256(_mm256_cmpeq_epi64(upper, reversed), _mm256_cmpeq_epi64(upper, reversedTenth));
+		SetMaskBits(mask, i, static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_andnot_si256(lastZero, equal)))));
+	}
+	GetPalindromeMaskScalar(in, mask, i, count);
+}
+
+
+// AVX-512
+// Comparisons give bit masks directly, so lanes are updated with masked moves
+
+template<typename T>
+TOLIK_AVX512_TARGET void GetPalindromeMask32AVX512(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	const __m512i tenMultiplier = _mm512_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m512i ten = _mm512_set1_epi32(10);
+	std::size_t i = first;
+	for(; i + 16 <= count; i += 16)
+	{
+		__m512i upper = LoadMagnitude32AVX512<kIsSignedInteger<T>>(in + i);
+		__m512i reversed = _mm512_setzero_si512();
+		const __mmask16 lastZero = _mm512_test_epi32_mask(upper, upper) &
+			_mm512_cmpeq_epi32_mask(upper, _mm512_mullo_epi32(_mm512_srli_epi32(MulHiU32AVX512(upper, tenMultiplier), 3), ten));
+		for(int step = 0; step < kHalfSteps32; step++)
+		{
+			const __m512i tenth = _mm512_srli_epi32(MulHiU32AVX512(upper, tenMultiplier), 3);
+			const __m512i digit = _mm512_sub_epi32(upper, _mm512_mullo_epi32(tenth, ten));
+			const __mmask16 active = _mm512_cmpgt_epu32_mask(upper, reversed);
+			reversed = _mm512_mask_add_epi32(reversed, active, _mm512_mullo_epi32(reversed, ten), digit);
+			upper = _mm512_mask_mov_epi32(upper, active, tenth);
+		}
+		const __m512i reversedTenth = _mm512_srli_epi32(MulHiU32AVX512(reversed, tenMultiplier), 3);
+		const __mmask16 equal = _mm512_cmpeq_epi32_mask(upper, reversed) | _mm512_cmpeq_epi32_mask(upper, reversedTenth);
+		SetMaskBits(mask, i, static_cast<uint64_t>(equal & ~lastZero & 0xFFFF));
+	}
+	GetPalindromeMask32AVX2(in, mask, i, count);
+}
+
+// 64-bit mullo needs AVX512DQ
+TOLIK_AVX512_TARGET inline __m512i Times10AVX512(__m512i value)
+{ return _mm512_add_epi64(_mm512_slli_epi64(value, 3), _mm512_slli_epi64(value, 1)); }
+
+template<typename T>
+TOLIK_AVX512_TARGET void GetPalindromeMask64AVX512(const T *in, uint64_t *mask, std::size_t first, std::size_t count)
+{
+	const __m512i tenMultiplier = _mm512_set1_epi64(static_cast<long long>(0xCCCCCCCCCCCCCCCDull));
+	std::size_t i = first;
+	for(; i + 8 <= count; i += 8)
+	{
+		__m512i upper = LoadMagnitude64AVX512<kIsSignedInteger<T>>(in + i);
+		__m512i reversed = _mm512_setzero_si512();
+		const __mmask8 lastZero = _mm512_test_epi64_mask(upper, upper) &
+			_mm512_cmpeq_epi64_mask(upper, Times10AVX512(_mm512_srli_epi64(MulHiU64AVX512(upper, tenMultiplier), 3)));
+		for(int step = 0; step < kHalfSteps64; step++)
+		{
+			const __m512i tenth = _mm512_srli_epi64(MulHiU64AVX512(upper, tenMultiplier), 3);
+			const __m512i digit = _mm512_sub_epi64(upper, Times10AVX512(tenth));
+			const __mmask8 active = _mm512_cmpgt_epu64_mask(upper, reversed);
+			if(active == 0)
+				break;
+			reversed = _mm512_mask_add_epi64(reversed, active, Times10AVX512(reversed), digit);
+			upper = _mm512_mask_mov_epi64(upper, active, tenth);
+		}
+		const __m512i reversedTenth = _mm512_srli_epi64(MulHiU64AVX512(reversed, tenMultiplier), 3);
+		const __mmask8 equal = _mm512_cmpeq_epi64_mask(upper, reversed) | _mm512_cmpeq_epi64_mask(upper, reversedTenth);
+		SetMaskBits(mask, i, static_cast<uint64_t>(equal & ~lastZero & 0xFF));
+	}
+	GetPalindromeMask64AVX2(in, mask, i, count);
+}
+
+#endif // TOLIK_BATCH_X86
+
+
+template<typename T>
+void GetPalindromeMaskDispatch(const T *in, uint64_t *mask, std::size_t count)
+{
+	std::memset(mask, 0, (count + 63) / 64 * sizeof(uint64_t));
+#ifdef TOLIK_BATCH_X86
+	switch(GetSimdLevel())
+	{
+	case SimdLevel::kAVX512:
+		if constexpr(sizeof(T) == 4)
+			return GetPalindromeMask32AVX512(in, mask, 0, count);
+		else
+			return GetPalindromeMask64AVX512(in, mask, 0, count);
+	case SimdLevel::kAVX2:
+		if constexpr(sizeof(T) == 4)
+			return GetPalindromeMask32AVX2(in, mask, 0, count);
+		else
+			return GetPalindromeMask64AVX2(in, mask, 0, count);
+	case SimdLevel::kSSE42:
+		// Two 64-bit lanes aren't faster than scalar code
+		if constexpr(sizeof(T) == 4)
+			return GetPalindromeMask32SSE42(in, mask, 0, count);
+		break;
+	case SimdLevel::kScalar:
+		break;
+	}
+#endif
+	GetPalindromeMaskScalar(in, mask, 0, count);
+}
+} // namespace
+
+
+void GetPalindromeMaskBatch(const uint32_t *in, uint64_t *mask, std::size_t count) { GetPalindromeMaskDispatch(in, mask, count); }
+void GetPalindromeMaskBatch(const uint64_t *in, uint64_t *mask, std::size_t count) { GetPalindromeMaskDispatch(in, mask, count); }
+void GetPalindromeMaskBatch(const int32_t *in, uint64_t *mask, std::size_t count) { GetPalindromeMaskDispatch(in, mask, count); }
+void GetPalindromeMaskBatch(const int64_t *in, uint64_t *mask, std::size_t count) { GetPalindromeMaskDispatch(in, mask, count); }
+} // detail
+} // palindrome
+} // Tolik
@@ -0,0 +1,86 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROMES_BATCH_HPP
+#define TOLIK_ALGORITHMS_PALINDROMES_BATCH_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Math/Batch.hpp"
+
+// Batch IsPalindrome for filtering large arrays
+// 32 and 64-bit integers go to SSE4.2/AVX2/AVX-512 kernels picked at runtime by GetSimdLevel() (see Utilities/Cpu.hpp),
+// they check 4, 8 or 16 values at once by reversing lower half of digits with multiply-shift division by 10
+// Other types use IsPalindrome in a loop
+
+namespace Tolik
+{
+namespace palindrome
+{
+namespace detail
+{
+// Defined in Algorithms/PalindromesBatch.cpp
+// Mask must have (count + 63) / 64 words
+void GetPalindromeMaskBatch(const uint32_t *in, uint64_t *mask, std::size_t count);
+void GetPalindromeMaskBatch(const uint64_t *in, uint64_t *mask, std::size_t count);
+void GetPalindromeMaskBatch(const int32_t *in, uint64_t *mask, std::size_t count);
+void GetPalindromeMaskBatch(const int64_t *in, uint64_t *mask, std::size_t count);
+
+// Values per mask computed by FilterPalindromes, so that mask stays on stack and in L1
+constexpr std::size_t kFilterChunkSize = 1024;
+} // detail
+
+// Bit i % 64 of mask[i / 64] is IsPalindrome(in[i]) for i in [0, count)
+// Mask must have (count + 63) / 64 words, unused bits of the last word are set to 0
+template<typename T>
+inline void GetPalindromeMask(const T *in, uint64_t *mask, std::size_t count)
+{
+	if constexpr(Tolik::detail::kHasBatchKernel<T>)
+		detail::GetPalindromeMaskBatch(reinterpret_cast<const Tolik::detail::BatchFixedType<T> *>(in), mask, count);
+	else
+	{
+		std::memset(mask, 0, (count + 63) / 64 * sizeof(uint64_t));
+		for(std::size_t i = 0; i < count; i++)
+			mask[i / 64] |= uint64_t(IsPalindrome(in[i])) << (i % 64);
+	}
+}
+
+// Writes every palindrome from in to out, order is kept, returns iterator past the last written value
+// Same as std::copy_if(in, in + count, out, IsPalindrome<T>)
+// Example: { 12, 121, 7, 10 } -> { 121, 7 }
+template<typename T, typename OutputIt>
+OutputIt FilterPalindromes(const T *in, std::size_t count, OutputIt out)
+{
+	uint64_t mask[detail::kFilterChunkSize / 64];
+	for(std::size_t first = 0; first < count; first += detail::kFilterChunkSize)
+	{
+		const std::size_t chunk = std::min(detail::kFilterChunkSize, count - first);
+		GetPalindromeMask(in + first, mask, chunk);
+		// Palindromes are rare, so only set bits are visited
+		for(std::size_t word = 0; word < (chunk + 63) / 64; word++)
+		{
+			for(uint64_t bits = mask[word]; bits != 0; bits &= bits - 1)
+				*out++ = in[first + word * 64 + static_cast<std::size_t>(__builtin_ctzll(bits))];
+		}
+	}
+	return out;
+}
+
+#if __cplusplus >= 202002L
+// Only values that have a bit in mask are processed: min(in.size(), mask.size() * 64)
+template<typename T>
+inline void GetPalindromeMask(std::span<const T> in, std::span<uint64_t> mask)
+{ GetPalindromeMask(in.data(), mask.data(), std::min(in.size(), mask.size() * 64)); }
+
+template<typename T, typename OutputIt>
+inline OutputIt FilterPalindromes(std::span<const T> in, OutputIt out)
+{ return FilterPalindromes(in.data(), in.size(), out); }
+#endif
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROMES_BATCH_HPP
@@ -0,0 +1,311 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROMES_PARALLEL_HPP
+#define TOLIK_ALGORITHMS_PALINDROMES_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+#include "Utilities/Type.hpp"
+
+// Multithreaded variants of palindrome enumeration
+// Search is split on the outer digit pairs: fixing them leaves independent subtree of detail::IteratePalindromes,
+// and subtrees are handed out to threads one at a time, so that thread that finished early takes the next one
+
+namespace Tolik
+{
+namespace palindrome
+{
+// Same as GetAllPalindromes(callback), but palindromes are enumerated on threadCount threads (0 = one per hardware thread)
+// Every thread calls its own copy of callback, in no particular order. Copies are returned when all threads are finished,
+// so that their results can be merged
+// Callback must not throw
+template<typename Functor>
+inline auto GetAllPalindromesParallel(Functor callback, std::size_t threadCount = 0) -> std::vector<Functor>;
+
+// Same as GetPalindromesDigitCountRange(digitCountRange, callback), see GetAllPalindromesParallel
+template<typename T, typename Functor>
+inline auto GetPalindromesDigitCountRangeParallel(const DigitCountRange<T> &digitCountRange, Functor callback, std::size_t threadCount = 0) -> std::vector<Functor>;
+
+// Same as GetPalindromesDigitRange(ranges, callback), see GetAllPalindromesParallel
+template<typename Functor>
+inline auto GetPalindromesDigitRangeParallel(const std::vector<DigitRange> &ranges, Functor callback, std::size_t threadCount = 0) -> std::vector<Functor>;
+
+// Ordered variants: filter is called on threadCount threads, every thread calls its own copy
+// Palindromes accepted by filter are passed to callback on calling thread in ascending order
+// Accepted palindromes of a subtree are kept until all subtrees before it are passed, so filter should be selective
+// Example: GetAllPalindromesOrdered([](uint32_t number) { return number % 7 == 0; }, [](uint32_t number) { std::cout << number << '\n'; });
+template<typename Predicate, typename Functor>
+inline void GetAllPalindromesOrdered(Predicate filter, Functor callback, std::size_t threadCount = 0);
+
+template<typename T, typename Predicate, typename Functor>
+inline void GetPalindromesDigitCountRangeOrdered(const DigitCountRange<T> &digitCountRange, Predicate filter, Functor callback, std::size_t threadCount = 0);
+
+template<typename Predicate, typename Functor>
+inline void GetPalindromesDigitRangeOrdered(const std::vector<DigitRange> &ranges, Predicate filter, Functor callback, std::size_t threadCount = 0);
+
+
+namespace detail
+{
+// Subtree of palindrome search: outer digit pairs are already added to number, digit is the outermost one left
+// digit = 0 means that number is complete palindrome
+// validRanges = nullptr means that every digit is allowed
+template<typename T>
+struct PalindromeTask
+{
+	T number = T(0);
+	DefUIntType digit = 0;
+	DefUIntType totalDigits = 0;
+	const std::vector<DigitRange> *validRanges = nullptr;
+};
+
+// Subtrees per thread and digit count, so that uneven subtrees are balanced
+constexpr inline std::size_t kPalindromeTasksPerThread = 16;
+
+inline std::size_t GetThreadCount(std::size_t threadCount)
+{ return threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()); }
+
+constexpr std::size_t kCacheLineSize = 64;
+
+// Copy of callback owned by one thread, on its own cache lines, so that stateful callbacks (counters, sums)
+// of different threads don't share them
+template<typename Functor>
+struct alignas(kCacheLineSize) ThreadCallback
+{
+	Functor value;
+};
+
+
+// Digits are fixed from the outermost pair, so subtrees are appended in ascending order
+template<typename T>
+void AppendPalindromeTasksImpl(std::vector<PalindromeTask<T>> &tasks, T number, DefUIntType digit, DefUIntType totalDigits, DefUIntType depth, const std::vector<DigitRange> *validRanges)
+{
+	if(depth == 0)
+	{
+		tasks.push_back({ number, digit, totalDigits, validRanges });
+		return;
+	}
+	const T diff = GetDiff<T>(digit, totalDigits);
+	const DigitRange range = GetDigitPairRange(digit, totalDigits, validRanges);
+	for(uint8_t i = range.min; i < range.max; i++)
+		AppendPalindromeTasksImpl(tasks, static_cast<T>(number + diff * T(i)), digit - 2, totalDigits, depth - 1, validRanges);
+}
+
+// Appends subtrees of palindromes with totalDigits digits in ascending order
+// Outer digit pairs are fixed until there are at least taskCount subtrees, or until no pair is left
+template<typename T>
+void AppendPalindromeTasks(std::vector<PalindromeTask<T>> &tasks, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges, std::size_t taskCount)
+{
+	DefUIntType depth = 0;
+	for(std::size_t count = 1; count < taskCount && depth < totalDigits / 2; depth++)
+	{
+		const DigitRange range = GetDigitPairRange(totalDigits - depth * 2, totalDigits, validRanges);
+		count *= range.max > range.min ? range.max - range.min : 1;
+	}
+	AppendPalindromeTasksImpl(tasks, T(0), totalDigits, totalDigits, depth, validRanges);
+}
+
+template<typename T, typename Functor>
+void RunPalindromeTask(const PalindromeTask<T> &task, Functor &callback)
+{
+	T number = task.number;
+	if(task.digit == 0)
+		callback(number);
+	else if(task.validRanges == nullptr)
+		IteratePalindromes(number, task.digit, task.totalDigits, std::ref(callback));
+	else
+		IteratePalindromesRanging(number, task.digit, task.totalDigits, *task.validRanges, std::ref(callback));
+}
+
+// Same order of subtrees as in GetAllPalindromes, validRangeBlocks must outlive tasks
+template<typename T>
+std::vector<PalindromeTask<T>> MakeAllPalindromesTasks(const std::vector<std::vector<DigitRange>> &validRangeBlocks, std::size_t threadCount)
+{
+	static_assert(std::numeric_limits<T>::is_specialized, "Need to know std::numeric_limits<T> in order to get all palindromes from this type");
+	std::vector<PalindromeTask<T>> tasks;
+	tasks.push_back({ T(0), 0, 0, nullptr });
+	for(DefUIntType digit = 1; digit < std::numeric_limits<T>::digits10 + 1; digit++)
+		AppendPalindromeTasks<T>(tasks, digit, nullptr, threadCount * kPalindromeTasksPerThread);
+	for(const std::vector<DigitRange> &validRanges : validRangeBlocks)
+		AppendPalindromeTasks<T>(tasks, std::numeric_limits<T>::digits10 + 1, &validRanges, threadCount * kPalindromeTasksPerThread);
+	return tasks;
+}
+
+template<typename T, typename U>
+std::vector<PalindromeTask<T>> MakeDigitCountRangeTasks(const DigitCountRange<U> &digitCountRange, std::size_t threadCount)
+{
+	std::vector<PalindromeTask<T>> tasks;
+	if(digitCountRange.min < 2 && 1 < digitCountRange.max)
+		tasks.push_back({ T(0), 0, 0, nullptr });
+	for(U digit = std::max(digitCountRange.min, U(1)); digit < digitCountRange.max; digit = digit + U(1))
+		AppendPalindromeTasks<T>(tasks, static_cast<DefUIntType>(digit), nullptr, threadCount * kPalindromeTasksPerThread);
+	return tasks;
+}
+
+// validRanges must outlive tasks
+template<typename T>
+std::vector<PalindromeTask<T>> MakeDigitRangeTasks(std::size_t digitCount, const std::vector<DigitRange> &validRanges, std::size_t threadCount)
+{
+	std::vector<PalindromeTask<T>> tasks;
+	if(digitCount == 1 && validRanges[0].min == 0 && 0 < validRanges[0].max)
+		tasks.push_back({ T(0), 0, 0, nullptr });
+	if(HasValidDigits(validRanges))
+		AppendPalindromeTasks<T>(tasks, digitCount, &validRanges, threadCount * kPalindromeTasksPerThread);
+	return tasks;
+}
+
+// Calls work(taskIndex, threadIndex) for every task on threadCount threads, calling thread is one of them
+// Tasks are taken one at a time from shared counter, so no thread is idle while there are tasks left
+template<typename Work>
+void RunTasks(std::size_t taskCount, std::size_t threadCount, Work work)
+{
+	std::atomic<std::size_t> next{0};
+	auto worker = [&](std::size_t threadIndex)
+	{
+		for(std::size_t i = next++; i < taskCount; i = next++)
+			work(i, threadIndex);
+	};
+
+	std::vector<std::thread> threads;
+	for(std::size_t i = 1; i < threadCount; i++)
+		threads.emplace_back(worker, i);
+	worker(0);
+	for(std::thread &thread : threads)
+		thread.join();
+}
+
+template<typename T, typename Functor>
+std::vector<Functor> RunPalindromeTasksParallel(const std::vector<PalindromeTask<T>> &tasks, const Functor &callback, std::size_t threadCount)
+{
+	std::vector<ThreadCallback<Functor>> callbacks(threadCount, ThreadCallback<Functor>{ callback });
+	RunTasks(tasks.size(), threadCount, [&](std::size_t taskIndex, std::size_t threadIndex)
+	{
+		RunPalindromeTask(tasks[taskIndex], callbacks[threadIndex].value);
+	});
+
+	std::vector<Functor> result;
+	result.reserve(threadCount);
+	for(ThreadCallback<Functor> &ownCallback : callbacks)
+		result.push_back(std::move(ownCallback.value));
+	return result;
+}
+
+// Calls collect(taskIndex, threadIndex, found) for every task on threadCount threads, while calling thread waits
+// for tasks in order and passes what they have found to callback
+template<typename T, typename Collect, typename Functor>
+void RunTasksOrdered(std::size_t taskCount, std::size_t threadCount, Collect collect, Functor &callback)
+{
+	std::vector<std::vector<T>> results(taskCount);
+	std::vector<char> finished(taskCount, false);
+	std::mutex mutex;
+	std::condition_variable taskFinished;
+
+	std::thread runner([&]()
+	{
+		RunTasks(taskCount, threadCount, [&](std::size_t taskIndex, std::size_t threadIndex)
+		{
+			std::vector<T> found;
+			collect(taskIndex, threadIndex, found);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				results[taskIndex] = std::move(found);
+				finished[taskIndex] = true;
+			}
+			taskFinished.notify_one();
+		});
+	});
+
+	for(std::size_t i = 0; i < taskCount; i++)
+	{
+		std::vector<T> found;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			taskFinished.wait(lock, [&]() { return finished[i] != 0; });
+			found = std::move(results[i]);
+		}
+		for(const T &number : found)
+			callback(number);
+	}
+	runner.join();
+}
+
+// Subtrees are enumerated on threadCount threads, while calling thread waits for them in order and passes accepted palindromes
+template<typename T, typename Predicate, typename Functor>
+void RunPalindromeTasksOrdered(const std::vector<PalindromeTask<T>> &tasks, const Predicate &filter, Functor &callback, std::size_t threadCount)
+{
+	std::vector<ThreadCallback<Predicate>> filters(threadCount, ThreadCallback<Predicate>{ filter });
+	RunTasksOrdered<T>(tasks.size(), threadCount, [&](std::size_t taskIndex, std::size_t threadIndex, std::vector<T> &found)
+	{
+		Predicate &ownFilter = filters[threadIndex].value;
+		auto collect = [&](T number)
+		{
+			if(ownFilter(number))
+				found.push_back(number);
+		};
+		RunPalindromeTask(tasks[taskIndex], collect);
+	}, callback);
+}
+} // detail
+
+
+template<typename Functor>
+auto GetAllPalindromesParallel(Functor callback, std::size_t threadCount) -> std::vector<Functor>
+{
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	const std::vector<std::vector<DigitRange>> validRangeBlocks = detail::GetValidRangeBlocksUpTo(std::numeric_limits<ReturnType>::max());
+	return detail::RunPalindromeTasksParallel(detail::MakeAllPalindromesTasks<ReturnType>(validRangeBlocks, threadCount), callback, threadCount);
+}
+
+template<typename T, typename Functor>
+auto GetPalindromesDigitCountRangeParallel(const DigitCountRange<T> &digitCountRange, Functor callback, std::size_t threadCount) -> std::vector<Functor>
+{
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	return detail::RunPalindromeTasksParallel(detail::MakeDigitCountRangeTasks<ReturnType>(digitCountRange, threadCount), callback, threadCount);
+}
+
+template<typename Functor>
+auto GetPalindromesDigitRangeParallel(const std::vector<DigitRange> &ranges, Functor callback, std::size_t threadCount) -> std::vector<Functor>
+{
+	using ReturnType = typename FunctorTraits<Functor>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	return detail::RunPalindromeTasksParallel(detail::MakeDigitRangeTasks<ReturnType>(ranges.size(), validRanges, threadCount), callback, threadCount);
+}
+
+template<typename Predicate, typename Functor>
+void GetAllPalindromesOrdered(Predicate filter, Functor callback, std::size_t threadCount)
+{
+	using ReturnType = typename FunctorTraits<Predicate>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	const std::vector<std::vector<DigitRange>> validRangeBlocks = detail::GetValidRangeBlocksUpTo(std::numeric_limits<ReturnType>::max());
+	detail::RunPalindromeTasksOrdered(detail::MakeAllPalindromesTasks<ReturnType>(validRangeBlocks, threadCount), filter, callback, threadCount);
+}
+
+template<typename T, typename Predicate, typename Functor>
+void GetPalindromesDigitCountRangeOrdered(const DigitCountRange<T> &digitCountRange, Predicate filter, Functor callback, std::size_t threadCount)
+{
+	using ReturnType = typename FunctorTraits<Predicate>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	detail::RunPalindromeTasksOrdered(detail::MakeDigitCountRangeTasks<ReturnType>(digitCountRange, threadCount), filter, callback, threadCount);
+}
+
+template<typename Predicate, typename Functor>
+void GetPalindromesDigitRangeOrdered(const std::vector<DigitRange> &ranges, Predicate filter, Functor callback, std::size_t threadCount)
+{
+	using ReturnType = typename FunctorTraits<Predicate>::template arg<0>::type;
+	threadCount = detail::GetThreadCount(threadCount);
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	detail::RunPalindromeTasksOrdered(detail::MakeDigitRangeTasks<ReturnType>(ranges.size(), validRanges, threadCount), filter, callback, threadCount);
+}
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROMES_PARALLEL_HPP
@@ -0,0 +1,189 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROMES_TEXT_HPP
+#define TOLIK_ALGORITHMS_PALINDROMES_TEXT_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include "Setup.hpp"
+#include "Algorithms/Palindromes.hpp"
+
+// Palindromes written as decimal text, one per line, without converting every number to string
+// Current palindrome is kept as characters: moving to the next one changes only the mirrored digit pair of the level
+// that was advanced, and every palindrome that differs only in the middle digit (pair) is a copy of the same record
+// with two characters changed. Records are copied into buffer with fixed size stores, so the output is limited
+// by memory bandwidth instead of division by 10
+// Example: GetPalindromesTextDigitCountRange(DigitCountRange(1, 3), buffer, 4096, callback) passes "0\n1\n2\n ... 9\n11\n22\n ... 99\n"
+
+namespace Tolik
+{
+namespace palindrome
+{
+// The longest palindrome text functions write, longer digit counts give nothing
+constexpr inline DefUIntType kMaxTextDigits = 31;
+// Records are copied this many bytes at a time, so buffer needs that much space past the last record
+constexpr inline std::size_t kTextRecordCapacity = kMaxTextDigits + 1;
+// The smallest bufferSize text functions accept: one run of 10 records
+constexpr inline std::size_t kMinTextBufferSize = kTextRecordCapacity * 10;
+
+// Same palindromes in the same order as GetPalindromesDigitCountRange, each followed by '\n'
+// callback(const char *text, std::size_t size) is called every time buffer has no room for the next run and once at the end,
+// text is not null-terminated. bufferSize must be at least kMinTextBufferSize, it is asserted
+template<typename T, typename Functor>
+inline void GetPalindromesTextDigitCountRange(const DigitCountRange<T> &digitCountRange, char *buffer, std::size_t bufferSize, Functor callback);
+
+// Same palindromes in the same order as GetPalindromesDigitRange, each followed by '\n'
+template<typename Functor>
+inline void GetPalindromesTextDigitRange(const std::vector<DigitRange> &ranges, char *buffer, std::size_t bufferSize, Functor callback);
+
+#if __cplusplus >= 202002L
+// Same as above with callback(std::span<const char> text)
+template<typename T, typename Functor>
+inline void GetPalindromesTextDigitCountRange(const DigitCountRange<T> &digitCountRange, std::span<char> buffer, Functor callback)
+{ GetPalindromesTextDigitCountRange(digitCountRange, buffer.data(), buffer.size(), [&](const char *text, std::size_t size) { callback(std::span<const char>(text, size)); }); }
+
+template<typename Functor>
+inline void GetPalindromesTextDigitRange(const std::vector<DigitRange> &ranges, std::span<char> buffer, Functor callback)
+{ GetPalindromesTextDigitRange(ranges, buffer.data(), buffer.size(), [&](const char *text, std::size_t size) { callback(std::span<const char>(text, size)); }); }
+#endif
+
+
+namespace detail
+{
+// Keeps the current palindrome as text and appends it to buffer, flushes buffer to callback when it gets full
+template<typename Functor>
+class PalindromeTextWriter
+{
+public:
+	PalindromeTextWriter(char *buffer, std::size_t bufferSize, Functor &callback) : m_buffer(buffer), m_bufferSize(bufferSize), m_callback(callback) {}
+
+	// Writes all palindromes with totalDigits digits, the same order as IteratePalindromeRuns
+	void Write(DefUIntType totalDigits, const std::vector<DigitRange> *validRanges);
+	// "0\n", 0 has no digits to iterate
+	void WriteZero();
+	// Pass text left in buffer
+	void Flush();
+
+private:
+	// digit is counted as in IteratePalindromes: pair (totalDigits - digit) / 2 from the outside is set on this level
+	void Iterate(DefUIntType digit, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges);
+	// Palindromes that differ only in the middle digit (pair), with middle digits from range
+	void WriteRun(DefUIntType digit, DefUIntType totalDigits, DigitRange range);
+
+	char *m_buffer;
+	std::size_t m_bufferSize;
+	std::size_t m_size = 0;
+	Functor &m_callback;
+	// Current palindrome and '\n' after it, the rest is copied along but overwritten by the next record
+	char m_record[kTextRecordCapacity] = {};
+};
+} // detail
+
+
+
+namespace detail
+{
+template<typename Functor>
+void PalindromeTextWriter<Functor>::Write(DefUIntType totalDigits, const std::vector<DigitRange> *validRanges)
+{
+	if(totalDigits == 0 || totalDigits > kMaxTextDigits)
+		return;
+	m_record[totalDigits] = '\n';
+	Iterate(totalDigits, totalDigits, validRanges);
+}
+
+template<typename Functor>
+void PalindromeTextWriter<Functor>::WriteZero()
+{
+	m_record[0] = '0';
+	m_record[1] = '\n';
+	WriteRun(1, 1, DigitRange(0, 1));
+}
+
+template<typename Functor>
+void PalindromeTextWriter<Functor>::Iterate(DefUIntType digit, DefUIntType totalDigits, const std::vector<DigitRange> *validRanges)
+{
+	const DigitRange range = GetDigitPairRange(digit, totalDigits, validRanges);
+	if(range.max <= range.min)
+		return;
+	if(digit <= 2)
+	{
+		WriteRun(digit, totalDigits, range);
+		return;
+	}
+	// Only this pair changes, the inner levels rewrite their own pairs
+	const DefUIntType left = (totalDigits - digit) / 2;
+	for(uint8_t i = range.min; i < range.max; i++)
+	{
+		m_record[left] = static_cast<char>('0' + i);
+		m_record[totalDigits - 1 - left] = static_cast<char>('0' + i);
+		Iterate(digit - 2, totalDigits, validRanges);
+	}
+}
+
+template<typename Functor>
+void PalindromeTextWriter<Functor>::WriteRun(DefUIntType digit, DefUIntType totalDigits, DigitRange range)
+{
+	// The last record of run writes kTextRecordCapacity bytes, so every record is checked against that
+	if(m_size + static_cast<std::size_t>(range.max - range.min) * kTextRecordCapacity > m_bufferSize)
+		Flush();
+	const std::size_t recordSize = static_cast<std::size_t>(totalDigits) + 1;
+	const DefUIntType left = (totalDigits - digit) / 2;
+	const DefUIntType right = totalDigits - 1 - left;
+	char *out = m_buffer + m_size;
+	for(uint8_t i = range.min; i < range.max; i++)
+	{
+		// Constant size lets compiler copy with a couple of vector stores instead of calling memcpy.
+		// Middle digits are patched in output, record itself isn't changed inside of run:
+		// wide load of bytes that were just stored one by one can't be forwarded from store buffer and stalls
+		std::memcpy(out, m_record, kTextRecordCapacity);
+		out[left] = static_cast<char>('0' + i);
+		out[right] = static_cast<char>('0' + i);
+		out += recordSize;
+	}
+	m_size = static_cast<std::size_t>(out - m_buffer);
+}
+
+template<typename Functor>
+void PalindromeTextWriter<Functor>::Flush()
+{
+	if(m_size != 0)
+		m_callback(static_cast<const char *>(m_buffer), m_size);
+	m_size = 0;
+}
+} // detail
+
+
+template<typename T, typename Functor>
+void GetPalindromesTextDigitCountRange(const DigitCountRange<T> &digitCountRange, char *buffer, std::size_t bufferSize, Functor callback)
+{
+	assert(bufferSize >= kMinTextBufferSize && "Buffer must hold one run of records");
+	detail::PalindromeTextWriter<Functor> writer(buffer, bufferSize, callback);
+	if(digitCountRange.min < 2 && 1 < digitCountRange.max)
+		writer.WriteZero();
+	for(T digit = std::max(digitCountRange.min, T(1)); digit < digitCountRange.max && digit <= T(kMaxTextDigits); digit = digit + T(1))
+		writer.Write(static_cast<DefUIntType>(digit), nullptr);
+	writer.Flush();
+}
+
+template<typename Functor>
+void GetPalindromesTextDigitRange(const std::vector<DigitRange> &ranges, char *buffer, std::size_t bufferSize, Functor callback)
+{
+	assert(bufferSize >= kMinTextBufferSize && "Buffer must hold one run of records");
+	detail::PalindromeTextWriter<Functor> writer(buffer, bufferSize, callback);
+	if(ranges.size() == 1 && ranges[0].min == 0 && 0 < ranges[0].max)
+		writer.WriteZero();
+	const std::vector<DigitRange> validRanges = detail::GetValidRanges(ranges);
+	if(!validRanges.empty())
+		writer.Write(static_cast<DefUIntType>(ranges.size()), &validRanges);
+	writer.Flush();
+}
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROMES_TEXT_HPP
@@ -0,0 +1,318 @@
+#include "Algorithms/PalindromicSubstrings.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "Setup.hpp"
+
+namespace Tolik
+{
+namespace palindrome
+{
+namespace
+{
+// Bytes of invalid UTF-8 become symbols past the last code point, so they don't match any code point
+constexpr uint32_t kInvalidByteSymbol = 0x110000;
+// History is trimmed when this many symbols can be dropped, so that it isn't moved on every symbol
+constexpr std::size_t kMinHistoryTrim = 1 << 16;
+
+// Length of UTF-8 sequence at the beginning of text, symbol is its code point
+// Invalid sequence gives 1 and kInvalidByteSymbol + its first byte, sequence cut by the end of text gives 0
+std::size_t DecodeUtf8(const unsigned char *text, std::size_t size, uint32_t &symbol)
+{
+	const unsigned char lead = text[0];
+	symbol = kInvalidByteSymbol + lead;
+	std::size_t length = 1;
+	uint32_t min = 0;
+	uint32_t value = lead;
+	if(lead < 0x80)
+	{
+		symbol = lead;
+		return 1;
+	}
+	else if((lead & 0xE0) == 0xC0)
+	{
+		length = 2;
+		min = 0x80;
+		value = lead & 0x1F;
+	}
+	else if((lead & 0xF0) == 0xE0)
+	{
+		length = 3;
+		min = 0x800;
+		value = lead & 0x0F;
+	}
+	else if((lead & 0xF8) == 0xF0)
+	{
+		length = 4;
+		min = 0x10000;
+		value = lead & 0x07;
+	}
+	else
+		return 1;
+
+	for(std::size_t i = 1; i < length; i++)
+	{
+		if(i == size)
+			return 0;
+		if((text[i] & 0xC0) != 0x80)
+			return 1;
+		value = (value << 6) | (text[i] & 0x3F);
+	}
+	// Overlong encodings, surrogates and values past the last code point
+	if(value < min || value > 0x10FFFF || (0xD800 <= value && value <= 0xDFFF))
+		return 1;
+	symbol = value;
+	return length;
+}
+
+// Code points of text and byte offset of every one of them and of the end
+void DecodeUtf8Text(std::string_view text, std::vector<uint32_t> &symbols, std::vector<uint32_t> &offsets)
+{
+	const unsigned char *data = reinterpret_cast<const unsigned char *>(text.data());
+	symbols.reserve(text.size());
+	offsets.reserve(text.size() + 1);
+	for(std::size_t i = 0; i < text.size();)
+	{
+		uint32_t symbol = 0;
+		// Sequence cut by the end of text is invalid as well
+		const std::size_t length = std::max<std::size_t>(DecodeUtf8(data + i, text.size() - i, symbol), 1);
+		symbols.push_back(symbol);
+		offsets.push_back(static_cast<uint32_t>(i));
+		i += length;
+	}
+	offsets.push_back(static_cast<uint32_t>(text.size()));
+}
+
+// radii[c] for every center c of "|s0|s1|...|", see ManacherTable
+// Palindrome that reaches the farthest to the right is kept, centers inside it start from radius of their mirror
+template<typename T>
+void FillRadii(const T *symbols, std::size_t count, std::vector<uint32_t> &radii)
+{
+	const std::size_t size = 2 * count + 1;
+	radii.assign(size, 0);
+	std::size_t center = 0;
+	std::size_t right = 0;
+	for(std::size_t i = 1; i < size; i++)
+	{
+		std::size_t radius = i < right ? std::min<std::size_t>(radii[2 * center - i], right - i) : 0;
+		// Separators (even positions) always match, so palindrome is extended to the next one right away
+		// and then only symbols are compared, two positions at a time
+		radius += (i + radius) % 2;
+		while(radius < i && i + radius + 1 < size && symbols[(i - radius - 2) / 2] == symbols[(i + radius) / 2])
+			radius += 2;
+		radii[i] = static_cast<uint32_t>(radius);
+		if(i + radius > right)
+		{
+			center = i;
+			right = i + radius;
+		}
+	}
+}
+} // namespace
+
+
+ManacherTable::ManacherTable(std::string_view text, TextEncoding encoding) : m_text(text)
+{
+	if(encoding == TextEncoding::kBytes)
+	{
+		FillRadii(reinterpret_cast<const unsigned char *>(text.data()), text.size(), m_radii);
+		return;
+	}
+	std::vector<uint32_t> symbols;
+	DecodeUtf8Text(text, symbols, m_byteOffsets);
+	FillRadii(symbols.data(), symbols.size(), m_radii);
+}
+
+std::string_view ManacherTable::GetLongest() const
+{
+	const std::size_t center = static_cast<std::size_t>(std::max_element(m_radii.begin(), m_radii.end()) - m_radii.begin());
+	const std::size_t first = (center - m_radii[center]) / 2;
+	const std::size_t offset = GetByteOffset(first);
+	return m_text.substr(offset, GetByteOffset(first + m_radii[center]) - offset);
+}
+
+uint64_t ManacherTable::CountPalindromes() const
+{
+	// Center with radius r has (r + 1) / 2 palindromes if it's a symbol (odd lengths), r / 2 if it's between symbols
+	uint64_t count = 0;
+	for(std::size_t i = 0; i < m_radii.size(); i++)
+		count += (m_radii[i] + (i & 1)) / 2;
+	return count;
+}
+
+std::string_view GetLongestPalindromicSubstring(std::string_view text, TextEncoding encoding)
+{ return ManacherTable(text, encoding).GetLongest(); }
+
+uint64_t CountPalindromicSubstrings(std::string_view text, TextEncoding encoding)
+{ return ManacherTable(text, encoding).CountPalindromes(); }
+
+
+PalindromicTree::PalindromicTree(TextEncoding encoding, uint64_t maxLength) :
+	m_encoding(encoding), m_maxLength(maxLength == 0 ? std::numeric_limits<uint64_t>::max() : maxLength)
+{
+	// Imaginary root of length -1 is parent of 1 symbol palindromes, empty root is parent of 2 symbol ones
+	// Suffix link of empty root goes to imaginary one, that can extend any suffix
+	Node imaginaryRoot;
+	imaginaryRoot.length = -1;
+	m_nodes.push_back(imaginaryRoot);
+	Node emptyRoot;
+	emptyRoot.link = kImaginaryRoot;
+	m_nodes.push_back(emptyRoot);
+}
+
+void PalindromicTree::Append(std::string_view chunk)
+{
+	const unsigned char *data = reinterpret_cast<const unsigned char *>(chunk.data());
+	if(m_encoding == TextEncoding::kBytes)
+	{
+		for(std::size_t i = 0; i < chunk.size(); i++)
+			AppendSymbol(data[i], 1);
+		return;
+	}
+
+	std::size_t start = 0;
+	if(m_pendingSize != 0)
+	{
+		// Sequence from the last chunk is finished with at most 4 bytes of this one
+		unsigned char joined[8] = {};
+		const std::size_t taken = std::min<std::size_t>(chunk.size(), 4);
+		std::memcpy(joined, m_pending.data(), m_pendingSize);
+		std::memcpy(joined + m_pendingSize, data, taken);
+		const std::size_t used = AppendUtf8(joined, m_pendingSize + taken, false);
+		if(used < m_pendingSize)
+		{
+			// Chunk is too short to finish it
+			m_pendingSize = m_pendingSize + taken - used;
+			std::memcpy(m_pending.data(), joined + used, m_pendingSize);
+			return;
+		}
+		start = used - m_pendingSize;
+		m_pendingSize = 0;
+	}
+	const std::size_t used = start + AppendUtf8(data + start, chunk.size() - start, false);
+	m_pendingSize = chunk.size() - used;
+	std::memcpy(m_pending.data(), data + used, m_pendingSize);
+}
+
+void PalindromicTree::Append(std::istream &in, std::size_t chunkSize)
+{
+	std::vector<char> buffer(std::max<std::size_t>(chunkSize, 1));
+	while(in)
+	{
+		in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+		Append(std::string_view(buffer.data(), static_cast<std::size_t>(in.gcount())));
+	}
+}
+
+void PalindromicTree::Finish()
+{
+	AppendUtf8(m_pending.data(), m_pendingSize, true);
+	m_pendingSize = 0;
+}
+
+std::size_t PalindromicTree::AppendUtf8(const unsigned char *text, std::size_t size, bool final)
+{
+	std::size_t i = 0;
+	while(i < size)
+	{
+		uint32_t symbol = 0;
+		std::size_t length = DecodeUtf8(text + i, size - i, symbol);
+		if(length == 0)
+		{
+			if(!final)
+				break;
+			// Cut sequence is invalid, its bytes go one by one, symbol is already set for the first one
+			length = 1;
+		}
+		AppendSymbol(symbol, static_cast<uint32_t>(length));
+		i += length;
+	}
+	return i;
+}
+
+void PalindromicTree::AppendSymbol(uint32_t symbol, uint32_t byteSize)
+{
+	const uint64_t position = m_symbolCount;
+	m_history.push_back(symbol);
+	m_symbolCount++;
+	m_byteCount += byteSize;
+
+	const uint32_t parent = FindExtendable(m_suffix, position, symbol);
+	uint32_t node = FindChild(parent, symbol);
+	// Imaginary root is nobody's child, so 0 means there is no such palindrome yet
+	if(node == kImaginaryRoot)
+	{
+		Node created;
+		created.length = m_nodes[parent].length + 2;
+		created.symbol = symbol;
+		if(created.length == 1)
+		{
+			created.byteSize = byteSize;
+			created.link = kEmptyRoot;
+		}
+		else
+		{
+			created.byteSize = m_nodes[parent].byteSize + 2 * uint64_t(byteSize);
+			// Suffix palindrome is always there: it's a mirror of prefix palindrome that was appended earlier
+			created.link = FindChild(FindExtendable(m_nodes[parent].link, position, symbol), symbol);
+		}
+		created.depth = m_nodes[created.link].depth + 1;
+		node = static_cast<uint32_t>(m_nodes.size());
+		m_nodes.push_back(created);
+		AddChild(parent, symbol, node);
+	}
+	m_suffix = node;
+	m_palindromeCount += m_nodes[node].depth;
+	if(m_nodes[node].byteSize > m_longest.size)
+		m_longest = { m_byteCount - m_nodes[node].byteSize, m_nodes[node].byteSize };
+
+	// The next symbol is compared only with the last m_maxLength - 1 symbols
+	const uint64_t needed = std::min(m_symbolCount, m_maxLength);
+	const std::size_t drop = static_cast<std::size_t>(m_symbolCount - needed - m_historyStart);
+	if(drop >= kMinHistoryTrim && drop >= m_history.size() / 2)
+	{
+		m_history.erase(m_history.begin(), m_history.begin() + static_cast<std::ptrdiff_t>(drop));
+		m_historyStart += drop;
+	}
+}
+
+uint32_t PalindromicTree::FindExtendable(uint32_t node, uint64_t position, uint32_t symbol) const
+{
+	while(true)
+	{
+		const int64_t length = m_nodes[node].length;
+		// Imaginary root extends anything: symbol is compared with itself
+		if(length < 0)
+			return node;
+		if(static_cast<uint64_t>(length) < position && static_cast<uint64_t>(length) + 2 <= m_maxLength && GetSymbol(position - static_cast<uint64_t>(length) - 1) == symbol)
+			return node;
+		node = m_nodes[node].link;
+	}
+}
+
+uint32_t PalindromicTree::FindChild(uint32_t node, uint32_t symbol) const
+{
+	if(node <= kEmptyRoot && symbol < kDirectSymbols)
+		return m_rootChildren[node][symbol];
+	for(uint32_t child = m_nodes[node].firstChild; child != 0; child = m_nodes[child].nextSibling)
+	{
+		if(m_nodes[child].symbol == symbol)
+			return child;
+	}
+	return 0;
+}
+
+void PalindromicTree::AddChild(uint32_t node, uint32_t symbol, uint32_t child)
+{
+	if(node <= kEmptyRoot && symbol < kDirectSymbols)
+	{
+		m_rootChildren[node][symbol] = child;
+		return;
+	}
+	m_nodes[child].nextSibling = m_nodes[node].firstChild;
+	m_nodes[node].firstChild = child;
+}
+} // palindrome
+} // Tolik
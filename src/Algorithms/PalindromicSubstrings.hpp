@@ -0,0 +1,156 @@
+#ifndef TOLIK_ALGORITHMS_PALINDROMIC_SUBSTRINGS_HPP
+#define TOLIK_ALGORITHMS_PALINDROMIC_SUBSTRINGS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string_view>
+#include <vector>
+
+#include "Setup.hpp"
+
+// Palindromes in text instead of numbers: substrings that read the same both ways
+// ManacherTable keeps palindrome radius around every center of text in memory, O(n) to build, then
+// any substring is checked in O(1). PalindromicTree (eertree) reads text symbol by symbol and keeps distinct palindromes,
+// with palindrome length limited it keeps only the last symbols, so it works on streams much bigger than memory.
+// Text is either bytes or UTF-8: in UTF-8 palindromes are made of code points, so "абба" is a palindrome,
+// bytes of invalid sequences are symbols of their own
+
+namespace Tolik
+{
+namespace palindrome
+{
+enum class TextEncoding : uint8_t
+{
+	kBytes,
+	kUtf8
+};
+
+// Position and size of palindrome in bytes
+struct TextSpan
+{
+	uint64_t offset = 0;
+	uint64_t size = 0;
+};
+
+// Palindrome radii of text, for substring queries
+// Positions in queries are indexes of symbols: bytes, or code points for UTF-8 (see GetByteOffset)
+// Text must be shorter than 2^31 bytes
+// Example: ManacherTable table("abacaba"); table.IsPalindrome(1, 4) = false ("bac"); table.GetLongest() = "abacaba"
+class ManacherTable
+{
+public:
+	// text must outlive table, GetLongest points into it
+	explicit ManacherTable(std::string_view text, TextEncoding encoding = TextEncoding::kBytes);
+
+	// Count of symbols
+	std::size_t size() const { return m_radii.size() / 2; }
+
+	// Is symbols [first, last) a palindrome, empty ranges are
+	bool IsPalindrome(std::size_t first, std::size_t last) const
+	{ return last <= first || m_radii[first + last] >= last - first; }
+
+	// The longest palindromic substring, the first one if there are several
+	std::string_view GetLongest() const;
+	// Count of palindromic substrings, every occurrence is counted: "aaa" = 6 (a a a aa aa aaa)
+	uint64_t CountPalindromes() const;
+	// Byte offset of symbol index in text, index can be size()
+	std::size_t GetByteOffset(std::size_t index) const { return m_byteOffsets.empty() ? index : m_byteOffsets[index]; }
+
+private:
+	std::string_view m_text;
+	// Radius around every center of "|s0|s1|...|": odd centers are symbols, even ones are between symbols
+	// Radius is the length of the longest palindrome with that center in symbols
+	std::vector<uint32_t> m_radii;
+	// Byte offset of every symbol and of the end, only for UTF-8
+	std::vector<uint32_t> m_byteOffsets;
+};
+
+// The same as ManacherTable(text, encoding).GetLongest() and CountPalindromes()
+std::string_view GetLongestPalindromicSubstring(std::string_view text, TextEncoding encoding = TextEncoding::kBytes);
+uint64_t CountPalindromicSubstrings(std::string_view text, TextEncoding encoding = TextEncoding::kBytes);
+
+
+// Eertree: node for every distinct palindrome, with link to its longest proper palindromic suffix
+// Text is appended in chunks of any size, UTF-8 sequences may be split between them
+// Palindrome that ends at the current symbol may grow back to the beginning of text, so every symbol is kept by default.
+// With maxLength only palindromes up to maxLength symbols are found (all of them), and only the last maxLength symbols
+// are kept: memory depends on count of distinct palindromes instead of text size
+// Example: PalindromicTree tree; tree.Append("abaab"); tree.CountDistinct() = 5 (a b aba aa baab); tree.CountPalindromes() = 8
+class PalindromicTree
+{
+public:
+	// maxLength = 0 means that palindromes aren't limited
+	explicit PalindromicTree(TextEncoding encoding = TextEncoding::kBytes, uint64_t maxLength = 0);
+
+	void Append(std::string_view chunk);
+	// Appends everything left in stream, chunkSize bytes at a time
+	void Append(std::istream &in, std::size_t chunkSize = 1 << 20);
+	// UTF-8 sequence cut by the end of text is appended as separate bytes
+	void Finish();
+
+	// Count of bytes appended
+	uint64_t size() const { return m_byteCount; }
+	// Count of distinct non-empty palindromic substrings
+	std::size_t CountDistinct() const { return m_nodes.size() - 2; }
+	// Count of palindromic substrings, every occurrence is counted
+	uint64_t CountPalindromes() const { return m_palindromeCount; }
+	// The longest palindromic substring, the first one if there are several
+	TextSpan GetLongest() const { return m_longest; }
+	// The longest palindromic suffix of text appended so far, in bytes
+	uint64_t GetLongestSuffixSize() const { return m_nodes[m_suffix].byteSize; }
+
+private:
+	struct Node
+	{
+		// In symbols, -1 for imaginary root
+		int64_t length = 0;
+		uint64_t byteSize = 0;
+		// Count of palindromic suffixes of this palindrome, itself included
+		uint64_t depth = 0;
+		uint32_t link = 0;
+		uint32_t firstChild = 0;
+		uint32_t nextSibling = 0;
+		// Symbol this palindrome adds around its parent
+		uint32_t symbol = 0;
+	};
+
+	static constexpr uint32_t kImaginaryRoot = 0;
+	static constexpr uint32_t kEmptyRoot = 1;
+	// Children of roots by symbols below 256 are looked up directly, they are the most frequent ones
+	static constexpr uint32_t kDirectSymbols = 256;
+
+	void AppendSymbol(uint32_t symbol, uint32_t byteSize);
+	// Appends whole UTF-8 sequences, returns count of bytes used. Sequence cut by the end is left unless final
+	std::size_t AppendUtf8(const unsigned char *text, std::size_t size, bool final);
+	// Symbol at index among all appended ones, it must be kept in history
+	uint32_t GetSymbol(uint64_t index) const { return m_history[static_cast<std::size_t>(index - m_historyStart)]; }
+	// Longest palindromic suffix of node (or node itself) that is preceded by symbol at position and not longer than
+	// m_maxLength with it
+	uint32_t FindExtendable(uint32_t node, uint64_t position, uint32_t symbol) const;
+	uint32_t FindChild(uint32_t node, uint32_t symbol) const;
+	void AddChild(uint32_t node, uint32_t symbol, uint32_t child);
+
+	TextEncoding m_encoding;
+	uint64_t m_maxLength;
+	std::vector<Node> m_nodes;
+	std::array<std::array<uint32_t, kDirectSymbols>, 2> m_rootChildren{};
+	uint32_t m_suffix = kEmptyRoot;
+
+	// Symbols from m_historyStart, the last m_maxLength ones at least
+	std::vector<uint32_t> m_history;
+	uint64_t m_historyStart = 0;
+	uint64_t m_symbolCount = 0;
+	uint64_t m_byteCount = 0;
+
+	uint64_t m_palindromeCount = 0;
+	TextSpan m_longest;
+	// Beginning of UTF-8 sequence left at the end of the last chunk
+	std::array<unsigned char, 4> m_pending{};
+	std::size_t m_pendingSize = 0;
+};
+} // palindrome
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_PALINDROMIC_SUBSTRINGS_HPP
@@ -0,0 +1,128 @@
+#ifndef TOLIK_ALGORITHMS_SEARCH_HPP
+#define TOLIK_ALGORITHMS_SEARCH_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Setup.hpp"
+
+// Branch-free searches in sorted data, for membership and rank queries on static tables
+// std::lower_bound branches on every comparison, and half of those branches are mispredicted on random queries.
+// BranchlessLowerBound picks the half with conditional move instead. EytzingerArray stores values in breadth first
+// order of implicit binary tree: the first levels share cache lines, and children of the next levels are prefetched
+// while the current one is compared
+
+namespace Tolik
+{
+// Same as std::lower_bound(sorted, sorted + count, value) - sorted
+// Always takes ceil(log2(count)) + 1 comparisons, so loop count doesn't depend on data
+template<typename T>
+constexpr inline std::size_t BranchlessLowerBound(const T *sorted, std::size_t count, const T &value);
+
+template<typename T>
+constexpr inline bool BranchlessContains(const T *sorted, std::size_t count, const T &value)
+{
+	const std::size_t index = BranchlessLowerBound(sorted, count, value);
+	return index < count && !(value < sorted[index]);
+}
+
+template<typename T, std::size_t N>
+constexpr inline std::size_t BranchlessLowerBound(const std::array<T, N> &sorted, const T &value)
+{ return BranchlessLowerBound(sorted.data(), N, value); }
+
+template<typename T, std::size_t N>
+constexpr inline bool BranchlessContains(const std::array<T, N> &sorted, const T &value)
+{ return BranchlessContains(sorted.data(), N, value); }
+
+
+// Sorted std::array<T, N> rearranged into Eytzinger layout: node k has children 2k and 2k + 1 (k starts from 1)
+// Rank of every node in sorted order is stored next to values, so queries answer the same as on sorted array
+// Example: constexpr EytzingerArray<int, 5> tree(std::array<int, 5>{ 1, 3, 5, 7, 9 }); tree.LowerBound(6) = 3
+template<typename T, std::size_t N>
+class EytzingerArray
+{
+public:
+	static_assert(N < (std::size_t(1) << 32), "EytzingerArray stores ranks as 32-bit integers");
+
+	constexpr explicit EytzingerArray(const std::array<T, N> &sorted) { Fill(sorted, 0, 1); }
+
+	static constexpr std::size_t size() { return N; }
+
+	// Same as std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()
+	constexpr std::size_t LowerBound(const T &value) const;
+	constexpr bool Contains(const T &value) const;
+
+private:
+	// Descends to the right while node is less than value, so the answer is the last node where it went left
+	// Returns 0 if it never did
+	constexpr std::size_t FindNode(const T &value) const;
+
+	// In-order walk of the implicit tree takes sorted values in order, returns index of the next sorted value
+	constexpr std::size_t Fill(const std::array<T, N> &sorted, std::size_t next, std::size_t node);
+
+	// Index 0 is unused, so that children of k are 2k and 2k + 1
+	std::array<T, N + 1> m_values{};
+	std::array<uint32_t, N + 1> m_ranks{};
+};
+
+
+
+template<typename T>
+constexpr std::size_t BranchlessLowerBound(const T *sorted, std::size_t count, const T &value)
+{
+	if(count == 0)
+		return 0;
+	const T *base = sorted;
+	// Multiplication by comparison result keeps compiler from turning it back into branch
+	for(std::size_t length = count; length > 1; length -= length / 2)
+		base += static_cast<std::size_t>(base[length / 2 - 1] < value) * (length / 2);
+	return static_cast<std::size_t>(base - sorted) + static_cast<std::size_t>(*base < value);
+}
+
+
+template<typename T, std::size_t N>
+constexpr std::size_t EytzingerArray<T, N>::Fill(const std::array<T, N> &sorted, std::size_t next, std::size_t node)
+{
+	if(node > N)
+		return next;
+	next = Fill(sorted, next, node * 2);
+	m_values[node] = sorted[next];
+	m_ranks[node] = static_cast<uint32_t>(next);
+	return Fill(sorted, next + 1, node * 2 + 1);
+}
+
+template<typename T, std::size_t N>
+constexpr std::size_t EytzingerArray<T, N>::FindNode(const T &value) const
+{
+	// Descendants of node few levels down are next to each other, starting from node * 2^levels,
+	// so one cache line of them is prefetched: 4 levels down for 4-byte values, 3 for 8-byte ones
+	constexpr std::size_t kPrefetchDistance = 64 / sizeof(T) > 1 ? 64 / sizeof(T) : 1;
+	std::size_t node = 1;
+	while(node <= N)
+	{
+		// Address is computed as integer, because it may be past the end, and prefetch never faults
+		if(!__builtin_is_constant_evaluated())
+			__builtin_prefetch(reinterpret_cast<const void *>(reinterpret_cast<uintptr_t>(m_values.data()) + node * kPrefetchDistance * sizeof(T)));
+		node = node * 2 + static_cast<std::size_t>(m_values[node] < value);
+	}
+	// Right turns are trailing 1 bits, the last left turn is the 0 before them
+	return node >> (__builtin_ctzll(~static_cast<unsigned long long>(node)) + 1);
+}
+
+template<typename T, std::size_t N>
+constexpr std::size_t EytzingerArray<T, N>::LowerBound(const T &value) const
+{
+	const std::size_t node = FindNode(value);
+	return node == 0 ? N : m_ranks[node];
+}
+
+template<typename T, std::size_t N>
+constexpr bool EytzingerArray<T, N>::Contains(const T &value) const
+{
+	const std::size_t node = FindNode(value);
+	return node != 0 && !(value < m_values[node]);
+}
+} // Tolik
+
+#endif // TOLIK_ALGORITHMS_SEARCH_HPP
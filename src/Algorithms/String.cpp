@@ -2,8 +2,12 @@
 
 #include <vector>
 #include <string>
+#include <cstring>
+#include <algorithm>
 
 #include "Setup.hpp"
+#include "Math/BatchSimd.hpp"
+#include "Utilities/Cpu.hpp"
 
 namespace Tolik
 {
@@ -26,4 +30,187 @@ std::vector<std::string> SplitString(const std::string &str, const std::string &
 	
 	return result;
 }
-} // Tolik
\ No newline at end of file
+
+
+namespace
+{
+// Every kernel calls callback(first, size) for non-empty tokens only
+
+template<typename Functor>
+inline void AddToken(Functor &callback, const char *first, std::size_t size)
+{
+	if(size != 0)
+		callback(first, size);
+}
+
+// Tail of tokens from position from, delimeters are searched from position search
+template<typename Functor>
+void SplitByteScalar(std::string_view str, char delimeter, std::size_t from, std::size_t search, Functor &callback)
+{
+	const char *data = str.data();
+	while(search < str.size())
+	{
+		const void *found = std::memchr(data + search, delimeter, str.size() - search);
+		if(found == nullptr)
+			break;
+		const std::size_t position = static_cast<std::size_t>(static_cast<const char *>(found) - data);
+		AddToken(callback, data + from, position - from);
+		from = search = position + 1;
+	}
+	AddToken(callback, data + from, str.size() - from);
+}
+
+template<typename Functor>
+void SplitSubstringScalar(std::string_view str, std::string_view delimeter, std::size_t from, std::size_t search, Functor &callback)
+{
+	for(std::size_t position = str.find(delimeter, search); position != std::string_view::npos; position = str.find(delimeter, from))
+	{
+		AddToken(callback, str.data() + from, position - from);
+		from = position + delimeter.size();
+	}
+	AddToken(callback, str.data() + from, str.size() - from);
+}
+
+
+#ifdef TOLIK_BATCH_X86
+// Bits of mask for positions before from are cleared, mask covers 32 positions from block
+inline uint32_t ClearBefore(uint32_t mask, std::size_t block, std::size_t from)
+{
+	if(from <= block)
+		return mask;
+	return from - block >= 32 ? 0 : mask & (~0u << (from - block));
+}
+
+// Every delimeter in block is a bit of mask, tokens end at them, so there is no call per token
+template<typename Functor>
+__attribute__((target("avx2"))) void SplitByteAVX2(std::string_view str, char delimeter, Functor &callback)
+{
+	const char *data = str.data();
+	const __m256i pattern = _mm256_set1_epi8(delimeter);
+	std::size_t from = 0;
+	for(std::size_t block = 0; block < str.size(); block += 32)
+	{
+		uint32_t mask = 0;
+		if(block + 32 <= str.size())
+			mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + block)), pattern)));
+		else
+		{
+			// Tail is copied to stack, so that short strings (lines of log) don't fall back to scalar code
+			alignas(32) char tail[32] = {};
+			const std::size_t tailSize = str.size() - block;
+			std::memcpy(tail, data + block, tailSize);
+			mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_load_si256(reinterpret_cast<const __m256i *>(tail)), pattern)));
+			mask &= (1u << tailSize) - 1;
+		}
+		for(; mask != 0; mask &= mask - 1)
+		{
+			const std::size_t position = block + static_cast<std::size_t>(__builtin_ctz(mask));
+			AddToken(callback, data + from, position - from);
+			from = position + 1;
+		}
+	}
+	AddToken(callback, data + from, str.size() - from);
+}
+
+// Candidates are positions where both the first and the last byte of delimeter match, only they are compared with memcmp
+// Candidates inside delimeter that was just found are dropped, so delimeters don't overlap
+template<typename Functor>
+__attribute__((target("avx2"))) void SplitSubstringAVX2(std::string_view str, std::string_view delimeter, Functor &callback)
+{
+	const char *data = str.data();
+	const std::size_t lastOffset = delimeter.size() - 1;
+	const __m256i first = _mm256_set1_epi8(delimeter.front());
+	const __m256i last = _mm256_set1_epi8(delimeter.back());
+	std::size_t from = 0;
+	std::size_t block = 0;
+	for(; block + lastOffset + 32 <= str.size(); block += 32)
+	{
+		const __m256i firstBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + block));
+		const __m256i lastBytes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + block + lastOffset));
+		const __m256i candidates = _mm256_and_si256(_mm256_cmpeq_epi8(firstBytes, first), _mm256_cmpeq_epi8(lastBytes, last));
+		uint32_t mask = ClearBefore(static_cast<uint32_t>(_mm256_movemask_epi8(candidates)), block, from);
+		while(mask != 0)
+		{
+			const std::size_t position = block + static_cast<std::size_t>(__builtin_ctz(mask));
+			if(std::memcmp(data + position + 1, delimeter.data() + 1, lastOffset - 1) == 0)
+			{
+				AddToken(callback, data + from, position - from);
+				from = position + delimeter.size();
+				mask = ClearBefore(mask, block, from);
+			}
+			else
+				mask &= mask - 1;
+		}
+	}
+	SplitSubstringScalar(str, delimeter, from, std::max(from, block), callback);
+}
+#endif // TOLIK_BATCH_X86
+
+
+template<typename Functor>
+void SplitByte(std::string_view str, char delimeter, Functor callback)
+{
+#ifdef TOLIK_BATCH_X86
+	// SSE4.2 isn't used: memchr of standard library is already vectorized, only per token calls are saved
+	if(GetSimdLevel() >= SimdLevel::kAVX2)
+		return SplitByteAVX2(str, delimeter, callback);
+#endif
+	SplitByteScalar(str, delimeter, 0, 0, callback);
+}
+
+template<typename Functor>
+void SplitSubstring(std::string_view str, std::string_view delimeter, Functor callback)
+{
+	if(delimeter.size() <= 1)
+	{
+		if(delimeter.size() == 1)
+			return SplitByte(str, delimeter.front(), callback);
+		for(std::size_t i = 0; i < str.size(); i++)
+			callback(str.data() + i, 1);
+		return;
+	}
+#ifdef TOLIK_BATCH_X86
+	if(GetSimdLevel() >= SimdLevel::kAVX2)
+		return SplitSubstringAVX2(str, delimeter, callback);
+#endif
+	SplitSubstringScalar(str, delimeter, 0, 0, callback);
+}
+} // namespace
+
+
+void SplitView(std::string_view str, char delimeter, std::vector<std::string_view> &tokens)
+{
+	tokens.clear();
+	SplitByte(str, delimeter, [&](const char *first, std::size_t size) { tokens.emplace_back(first, size); });
+}
+
+void SplitView(std::string_view str, std::string_view delimeter, std::vector<std::string_view> &tokens)
+{
+	tokens.clear();
+	SplitSubstring(str, delimeter, [&](const char *first, std::size_t size) { tokens.emplace_back(first, size); });
+}
+
+std::size_t SplitView(std::string_view str, char delimeter, std::string_view *tokens, std::size_t capacity)
+{
+	std::size_t count = 0;
+	SplitByte(str, delimeter, [&](const char *first, std::size_t size)
+	{
+		if(count < capacity)
+			tokens[count] = std::string_view(first, size);
+		count++;
+	});
+	return count;
+}
+
+std::size_t SplitView(std::string_view str, std::string_view delimeter, std::string_view *tokens, std::size_t capacity)
+{
+	std::size_t count = 0;
+	SplitSubstring(str, delimeter, [&](const char *first, std::size_t size)
+	{
+		if(count < capacity)
+			tokens[count] = std::string_view(first, size);
+		count++;
+	});
+	return count;
+}
+} // Tolik
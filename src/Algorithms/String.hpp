@@ -1,8 +1,13 @@
 #ifndef TOLIK_ALGORITHMS_STRING_HPP
 #define TOLIK_ALGORITHMS_STRING_HPP
 
+#include <cstddef>
 #include <vector>
 #include <string>
+#include <string_view>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 #include "Setup.hpp"
 
@@ -12,6 +17,26 @@ std::vector<std::string> SplitString(const std::string &str, const std::string &
 inline std::vector<std::string> SplitString(const std::string &str, char delimeter)
 { return SplitString(str, std::string(1, delimeter)); }
 
+// Zero-copy SplitString: tokens are views into str, so str must outlive them. Empty tokens are skipped as well
+// Delimeters are found from left to right, each one after the end of the previous one, empty delimeter splits str into characters
+// Delimeter search goes to AVX2 kernel picked at runtime by GetSimdLevel() (see Utilities/Cpu.hpp): one byte is compared
+// with 32 bytes at once, longer delimeters are found by their first and last bytes and only those candidates are compared whole
+// Example: SplitView("12  34 56", ' ', tokens); tokens = { "12", "34", "56" }
+
+// tokens is cleared first and its capacity is reused, so there are no allocations once it's big enough
+void SplitView(std::string_view str, char delimeter, std::vector<std::string_view> &tokens);
+void SplitView(std::string_view str, std::string_view delimeter, std::vector<std::string_view> &tokens);
+// Writes at most capacity tokens, returns count of all of them, so result > capacity means that tokens didn't fit
+std::size_t SplitView(std::string_view str, char delimeter, std::string_view *tokens, std::size_t capacity);
+std::size_t SplitView(std::string_view str, std::string_view delimeter, std::string_view *tokens, std::size_t capacity);
+
+#if __cplusplus >= 202002L
+inline std::size_t SplitView(std::string_view str, char delimeter, std::span<std::string_view> tokens)
+{ return SplitView(str, delimeter, tokens.data(), tokens.size()); }
+inline std::size_t SplitView(std::string_view str, std::string_view delimeter, std::span<std::string_view> tokens)
+{ return SplitView(str, delimeter, tokens.data(), tokens.size()); }
+#endif
+
 // TODO:
 // 1. Encodings (wide char, utf8, utf16, utf32)
 // 2. String reverse (with consideration of encoding)
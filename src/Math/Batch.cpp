@@ -0,0 +1,387 @@
+#include "Math/Batch.hpp"
+
+#include <cstring>
+
+#include "Setup.hpp"
+#include "Math/BatchSimd.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Cpu.hpp"
+
+namespace Tolik
+{
+namespace detail
+{
+namespace
+{
+constexpr uint32_t kPowers32[16] =
+{
+	1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u,
+	// Padding for full register lookup
+	0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu
+};
+
+constexpr uint64_t kPowers64[24] =
+{
+	1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+	100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull, 1000000000000000ull,
+	10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+	// Padding for full register lookup
+	~0ull, ~0ull, ~0ull, ~0ull
+};
+
+// Digit counts of 32-bit values are compared against 10^0..10^9 and 64-bit against 10^0..10^19
+constexpr int kPowerCount32 = 10;
+constexpr int kPowerCount64 = 20;
+
+template<typename T>
+void DigitCountScalar(const T *in, uint8_t *out, std::size_t count)
+{
+	for(std::size_t i = 0; i < count; i++)
+		out[i] = static_cast<uint8_t>(DigitCount(in[i]));
+}
+
+template<typename T>
+void GetDigitScalar(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<MakeUnsignedT<T>> &magic)
+{
+	for(std::size_t i = 0; i < count; i++)
+		out[i] = static_cast<uint8_t>(ApplyDivisionMagic(UnsignedAbs(in[i]), magic) % 10u);
+}
+
+
+#ifdef TOLIK_BATCH_X86
+// SSE4.2
+
+// Low byte of each 32-bit lane to 4 bytes in out
+__attribute__((target("sse4.2"))) inline void Store4x32SSE42(uint8_t *out, __m128i value)
+{
+	const int packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(value, _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1)));
+	std::memcpy(out, &packed, 4);
+}
+
+template<typename T>
+__attribute__((target("sse4.2"))) void DigitCount32SSE42(const T *in, uint8_t *out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i value = LoadMagnitude32SSE42<kIsSignedInteger<T>>(in + i);
+		__m128i digits = _mm_setzero_si128();
+		// value >= 10^k is the same as max(value, 10^k) == value
+		#pragma GCC unroll 10
+		for(int k = 0; k < kPowerCount32; k++)
+		{
+			const __m128i power = _mm_set1_epi32(static_cast<int>(kPowers32[k]));
+			digits = _mm_sub_epi32(digits, _mm_cmpeq_epi32(_mm_max_epu32(value, power), value));
+		}
+		Store4x32SSE42(out + i, digits);
+	}
+	DigitCountScalar(in + i, out + i, count - i);
+}
+
+template<typename T>
+__attribute__((target("sse4.2"))) void GetDigit32SSE42(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<uint32_t> &magic)
+{
+	const __m128i multiplier = _mm_set1_epi32(static_cast<int>(magic.multiplier));
+	const __m128i shift1 = _mm_cvtsi32_si128(magic.shift1);
+	const __m128i shift2 = _mm_cvtsi32_si128(magic.shift2);
+	// x / 10 = mulhi(x, 0xCCCCCCCD) >> 3 for every 32-bit x
+	const __m128i tenMultiplier = _mm_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m128i ten = _mm_set1_epi32(10);
+
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m128i value = LoadMagnitude32SSE42<kIsSignedInteger<T>>(in + i);
+		const __m128i high = MulHiU32(value, multiplier);
+		const __m128i quotient = _mm_srl_epi32(_mm_add_epi32(high, _mm_srl_epi32(_mm_sub_epi32(value, high), shift1)), shift2);
+		const __m128i tenth = _mm_srli_epi32(MulHiU32(quotient, tenMultiplier), 3);
+		Store4x32SSE42(out + i, _mm_sub_epi32(quotient, _mm_mullo_epi32(tenth, ten)));
+	}
+	GetDigitScalar(in + i, out + i, count - i, magic);
+}
+
+// AVX2
+
+// Low byte of each 32-bit lane to 8 bytes in out
+__attribute__((target("avx2"))) inline void Store8x32AVX2(uint8_t *out, __m256i value)
+{
+	// Lower half puts its bytes at 0..3 and upper half at 4..7, so halves can be merged with or
+	const __m256i shuffled = _mm256_shuffle_epi8(value, _mm256_setr_epi8(
+		0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, -1, -1, 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1));
+	_mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_or_si128(_mm256_castsi256_si128(shuffled), _mm256_extracti128_si256(shuffled, 1)));
+}
+
+// Low byte of each 64-bit lane to 4 bytes in out
+__attribute__((target("avx2"))) inline void Store4x64AVX2(uint8_t *out, __m256i value)
+{
+	const __m256i shuffled = _mm256_shuffle_epi8(value, _mm256_setr_epi8(
+		0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+		-1, -1, 0, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1));
+	const int packed = _mm_cvtsi128_si32(_mm_or_si128(_mm256_castsi256_si128(shuffled), _mm256_extracti128_si256(shuffled, 1)));
+	std::memcpy(out, &packed, 4);
+}
+
+template<typename T>
+__attribute__((target("avx2"))) void DigitCount32AVX2(const T *in, uint8_t *out, std::size_t count)
+{
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256i value = LoadMagnitude32AVX2<kIsSignedInteger<T>>(in + i);
+		__m256i digits = _mm256_setzero_si256();
+		#pragma GCC unroll 10
+		for(int k = 0; k < kPowerCount32; k++)
+		{
+			const __m256i power = _mm256_set1_epi32(static_cast<int>(kPowers32[k]));
+			digits = _mm256_sub_epi32(digits, _mm256_cmpeq_epi32(_mm256_max_epu32(value, power), value));
+		}
+		Store8x32AVX2(out + i, digits);
+	}
+	DigitCount32SSE42(in + i, out + i, count - i);
+}
+
+// AVX2 has no 64-bit lzcnt, but exponent of double holds the bit width
+// Halves are converted separately, because 32-bit integer converts to double exactly
+template<typename T>
+__attribute__((target("avx2"))) void DigitCount64AVX2(const T *in, uint8_t *out, std::size_t count)
+{
+	// Bits of 2^52 as double. Or-ing 32-bit n into mantissa and subtracting 2^52 gives n as double
+	const __m256i magic = _mm256_set1_epi64x(0x4330000000000000ll);
+	const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFF);
+	const __m256i one = _mm256_set1_epi64x(1);
+
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m256i value = LoadMagnitude64AVX2<kIsSignedInteger<T>>(in + i);
+		const __m256i valueOrOne = _mm256_or_si256(value, one);
+		const __m256i high = _mm256_srli_epi64(valueOrOne, 32);
+		const __m256d highDouble = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(high, magic)), _mm256_castsi256_pd(magic));
+		const __m256d lowDouble = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(valueOrOne, low32), magic)), _mm256_castsi256_pd(magic));
+		// Biased exponent - 1022 equals bit width
+		const __m256i highWidth = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(highDouble), 52), _mm256_set1_epi64x(1022 - 32));
+		const __m256i lowWidth = _mm256_sub_epi64(_mm256_srli_epi64(_mm256_castpd_si256(lowDouble), 52), _mm256_set1_epi64x(1022));
+		const __m256i width = _mm256_blendv_epi8(highWidth, lowWidth, _mm256_cmpeq_epi64(high, _mm256_setzero_si256()));
+
+		const __m256i approximation = _mm256_srli_epi64(_mm256_mul_epu32(width, _mm256_set1_epi64x(1233)), 12);
+		const __m256i power = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(kPowers64), approximation, 8);
+		// approximation + (value >= power) = approximation + 1 - (power > value)
+		const __m256i digits = _mm256_add_epi64(_mm256_add_epi64(approximation, one), GreaterU64AVX2(power, value));
+		Store4x64AVX2(out + i, digits);
+	}
+	DigitCountScalar(in + i, out + i, count - i);
+}
+
+template<typename T>
+__attribute__((target("avx2"))) void GetDigit32AVX2(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<uint32_t> &magic)
+{
+	const __m256i multiplier = _mm256_set1_epi32(static_cast<int>(magic.multiplier));
+	const __m128i shift1 = _mm_cvtsi32_si128(magic.shift1);
+	const __m128i shift2 = _mm_cvtsi32_si128(magic.shift2);
+	const __m256i tenMultiplier = _mm256_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m256i ten = _mm256_set1_epi32(10);
+
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m256i value = LoadMagnitude32AVX2<kIsSignedInteger<T>>(in + i);
+		const __m256i high = MulHiU32AVX2(value, multiplier);
+		const __m256i quotient = _mm256_srl_epi32(_mm256_add_epi32(high, _mm256_srl_epi32(_mm256_sub_epi32(value, high), shift1)), shift2);
+		const __m256i tenth = _mm256_srli_epi32(MulHiU32AVX2(quotient, tenMultiplier), 3);
+		Store8x32AVX2(out + i, _mm256_sub_epi32(quotient, _mm256_mullo_epi32(tenth, ten)));
+	}
+	GetDigit32SSE42(in + i, out + i, count - i, magic);
+}
+
+template<typename T>
+__attribute__((target("avx2"))) void GetDigit64AVX2(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<uint64_t> &magic)
+{
+	const __m256i multiplier = _mm256_set1_epi64x(static_cast<long long>(magic.multiplier));
+	const __m128i shift1 = _mm_cvtsi32_si128(magic.shift1);
+	const __m128i shift2 = _mm_cvtsi32_si128(magic.shift2);
+	const __m256i tenMultiplier = _mm256_set1_epi64x(static_cast<long long>(0xCCCCCCCCCCCCCCCDull));
+
+	std::size_t i = 0;
+	for(; i + 4 <= count; i += 4)
+	{
+		const __m256i value = LoadMagnitude64AVX2<kIsSignedInteger<T>>(in + i);
+		const __m256i high = MulHiU64AVX2(value, multiplier);
+		const __m256i quotient = _mm256_srl_epi64(_mm256_add_epi64(high, _mm256_srl_epi64(_mm256_sub_epi64(value, high), shift1)), shift2);
+		const __m256i tenth = _mm256_srli_epi64(MulHiU64AVX2(quotient, tenMultiplier), 3);
+		const __m256i tenthTimesTen = _mm256_add_epi64(_mm256_slli_epi64(tenth, 3), _mm256_slli_epi64(tenth, 1));
+		Store4x64AVX2(out + i, _mm256_sub_epi64(quotient, tenthTimesTen));
+	}
+	GetDigitScalar(in + i, out + i, count - i, magic);
+}
+
+
+// AVX-512
+// Digit count here is the same as in DigitCount from Math/Utils.hpp:
+// bit width by lzcnt, approximation by * 1233 >> 12 and one power lookup with permute
+
+template<typename T>
+TOLIK_AVX512_TARGET void DigitCount32AVX512(const T *in, uint8_t *out, std::size_t count)
+{
+	const __m512i powers = _mm512_loadu_si512(kPowers32);
+	const __m512i one = _mm512_set1_epi32(1);
+
+	std::size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		const __m512i value = LoadMagnitude32AVX512<kIsSignedInteger<T>>(in + i);
+		const __m512i width = _mm512_sub_epi32(_mm512_set1_epi32(32), _mm512_lzcnt_epi32(_mm512_or_si512(value, one)));
+		const __m512i approximation = _mm512_srli_epi32(_mm512_mullo_epi32(width, _mm512_set1_epi32(1233)), 12);
+		const __m512i power = _mm512_permutexvar_epi32(approximation, powers);
+		const __m512i digits = _mm512_mask_add_epi32(approximation, _mm512_cmpge_epu32_mask(value, power), approximation, one);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm512_cvtepi32_epi8(digits));
+	}
+	DigitCount32AVX2(in + i, out + i, count - i);
+}
+
+template<typename T>
+TOLIK_AVX512_TARGET void DigitCount64AVX512(const T *in, uint8_t *out, std::size_t count)
+{
+	// 20 powers don't fit in one register, so lookup is split into [0, 16) and [16, 24)
+	const __m512i powersLow = _mm512_loadu_si512(kPowers64);
+	const __m512i powersMiddle = _mm512_loadu_si512(kPowers64 + 8);
+	const __m512i powersHigh = _mm512_loadu_si512(kPowers64 + 16);
+	const __m512i one = _mm512_set1_epi64(1);
+	const __m512i sixteen = _mm512_set1_epi64(16);
+
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m512i value = LoadMagnitude64AVX512<kIsSignedInteger<T>>(in + i);
+		const __m512i width = _mm512_sub_epi64(_mm512_set1_epi64(64), _mm512_lzcnt_epi64(_mm512_or_si512(value, one)));
+		const __m512i approximation = _mm512_srli_epi64(_mm512_mul_epu32(width, _mm512_set1_epi64(1233)), 12);
+		const __m512i powerLow = _mm512_permutex2var_epi64(powersLow, approximation, powersMiddle);
+		const __m512i powerHigh = _mm512_permutexvar_epi64(approximation, powersHigh);
+		const __m512i power = _mm512_mask_blend_epi64(_mm512_cmpge_epu64_mask(approximation, sixteen), powerLow, powerHigh);
+		const __m512i digits = _mm512_mask_add_epi64(approximation, _mm512_cmpge_epu64_mask(value, power), approximation, one);
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm512_cvtepi64_epi8(digits));
+	}
+	DigitCount64AVX2(in + i, out + i, count - i);
+}
+
+template<typename T>
+TOLIK_AVX512_TARGET void GetDigit32AVX512(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<uint32_t> &magic)
+{
+	const __m512i multiplier = _mm512_set1_epi32(static_cast<int>(magic.multiplier));
+	const __m128i shift1 = _mm_cvtsi32_si128(magic.shift1);
+	const __m128i shift2 = _mm_cvtsi32_si128(magic.shift2);
+	const __m512i tenMultiplier = _mm512_set1_epi32(static_cast<int>(0xCCCCCCCDu));
+	const __m512i ten = _mm512_set1_epi32(10);
+
+	std::size_t i = 0;
+	for(; i + 16 <= count; i += 16)
+	{
+		const __m512i value = LoadMagnitude32AVX512<kIsSignedInteger<T>>(in + i);
+		const __m512i high = MulHiU32AVX512(value, multiplier);
+		const __m512i quotient = _mm512_srl_epi32(_mm512_add_epi32(high, _mm512_srl_epi32(_mm512_sub_epi32(value, high), shift1)), shift2);
+		const __m512i tenth = _mm512_srli_epi32(MulHiU32AVX512(quotient, tenMultiplier), 3);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm512_cvtepi32_epi8(_mm512_sub_epi32(quotient, _mm512_mullo_epi32(tenth, ten))));
+	}
+	GetDigit32AVX2(in + i, out + i, count - i, magic);
+}
+
+template<typename T>
+TOLIK_AVX512_TARGET void GetDigit64AVX512(const T *in, uint8_t *out, std::size_t count, const DivisionMagic<uint64_t> &magic)
+{
+	const __m512i multiplier = _mm512_set1_epi64(static_cast<long long>(magic.multiplier));
+	const __m128i shift1 = _mm_cvtsi32_si128(magic.shift1);
+	const __m128i shift2 = _mm_cvtsi32_si128(magic.shift2);
+	const __m512i tenMultiplier = _mm512_set1_epi64(static_cast<long long>(0xCCCCCCCCCCCCCCCDull));
+
+	std::size_t i = 0;
+	for(; i + 8 <= count; i += 8)
+	{
+		const __m512i value = LoadMagnitude64AVX512<kIsSignedInteger<T>>(in + i);
+		const __m512i high = MulHiU64AVX512(value, multiplier);
+		const __m512i quotient = _mm512_srl_epi64(_mm512_add_epi64(high, _mm512_srl_epi64(_mm512_sub_epi64(value, high), shift1)), shift2);
+		const __m512i tenth = _mm512_srli_epi64(MulHiU64AVX512(quotient, tenMultiplier), 3);
+		const __m512i tenthTimesTen = _mm512_add_epi64(_mm512_slli_epi64(tenth, 3), _mm512_slli_epi64(tenth, 1));
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), _mm512_cvtepi64_epi8(_mm512_sub_epi64(quotient, tenthTimesTen)));
+	}
+	GetDigit64AVX2(in + i, out + i, count - i, magic);
+}
+
+#endif // TOLIK_BATCH_X86
+
+
+template<typename T>
+void DigitCountDispatch(const T *in, uint8_t *out, std::size_t count)
+{
+#ifdef TOLIK_BATCH_X86
+	switch(GetSimdLevel())
+	{
+	case SimdLevel::kAVX512:
+		if constexpr(sizeof(T) == 4)
+			return DigitCount32AVX512(in, out, count);
+		else
+			return DigitCount64AVX512(in, out, count);
+	case SimdLevel::kAVX2:
+		if constexpr(sizeof(T) == 4)
+			return DigitCount32AVX2(in, out, count);
+		else
+			return DigitCount64AVX2(in, out, count);
+	case SimdLevel::kSSE42:
+		// Two 64-bit lanes aren't faster than scalar code
+		if constexpr(sizeof(T) == 4)
+			return DigitCount32SSE42(in, out, count);
+		break;
+	case SimdLevel::kScalar:
+		break;
+	}
+#endif
+	DigitCountScalar(in, out, count);
+}
+
+template<typename T>
+void GetDigitDispatch(const T *in, uint8_t *out, std::size_t count, DefIntType index)
+{
+	using UnsignedT = MakeUnsignedT<T>;
+	if(index < 0 || kMaxDigits<T> <= index)
+	{
+		std::memset(out, 0, count);
+		return;
+	}
+	const DivisionMagic<UnsignedT> &magic = kPower10Magic<UnsignedT>[index];
+
+#ifdef TOLIK_BATCH_X86
+	switch(GetSimdLevel())
+	{
+	case SimdLevel::kAVX512:
+		if constexpr(sizeof(T) == 4)
+			return GetDigit32AVX512(in, out, count, magic);
+		else
+			return GetDigit64AVX512(in, out, count, magic);
+	case SimdLevel::kAVX2:
+		if constexpr(sizeof(T) == 4)
+			return GetDigit32AVX2(in, out, count, magic);
+		else
+			return GetDigit64AVX2(in, out, count, magic);
+	case SimdLevel::kSSE42:
+		if constexpr(sizeof(T) == 4)
+			return GetDigit32SSE42(in, out, count, magic);
+		break;
+	case SimdLevel::kScalar:
+		break;
+	}
+#endif
+	GetDigitScalar(in, out, count, magic);
+}
+} // namespace
+
+
+void DigitCountBatch(const uint32_t *in, uint8_t *out, std::size_t count) { DigitCountDispatch(in, out, count); }
+void DigitCountBatch(const uint64_t *in, uint8_t *out, std::size_t count) { DigitCountDispatch(in, out, count); }
+void DigitCountBatch(const int32_t *in, uint8_t *out, std::size_t count) { DigitCountDispatch(in, out, count); }
+void DigitCountBatch(const int64_t *in, uint8_t *out, std::size_t count) { DigitCountDispatch(in, out, count); }
+
+void GetDigitBatch(const uint32_t *in, uint8_t *out, std::size_t count, DefIntType index) { GetDigitDispatch(in, out, count, index); }
+void GetDigitBatch(const uint64_t *in, uint8_t *out, std::size_t count, DefIntType index) { GetDigitDispatch(in, out, count, index); }
+void GetDigitBatch(const int32_t *in, uint8_t *out, std::size_t count, DefIntType index) { GetDigitDispatch(in, out, count, index); }
+void GetDigitBatch(const int64_t *in, uint8_t *out, std::size_t count, DefIntType index) { GetDigitDispatch(in, out, count, index); }
+} // detail
+} // Tolik
@@ -0,0 +1,92 @@
+#ifndef TOLIK_MATH_BATCH_HPP
+#define TOLIK_MATH_BATCH_HPP
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include "Setup.hpp"
+#include "Math/Constants.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Type.hpp"
+
+// Batch versions of functions from Math/Utils.hpp, that process whole arrays at once
+// 32 and 64-bit integers go to SSE4.2/AVX2/AVX-512 kernels picked at runtime by GetSimdLevel() (see Utilities/Cpu.hpp)
+// Other types use scalar loop
+
+namespace Tolik
+{
+namespace detail
+{
+// Defined in Math/Batch.cpp
+void DigitCountBatch(const uint32_t *in, uint8_t *out, std::size_t count);
+void DigitCountBatch(const uint64_t *in, uint8_t *out, std::size_t count);
+void DigitCountBatch(const int32_t *in, uint8_t *out, std::size_t count);
+void DigitCountBatch(const int64_t *in, uint8_t *out, std::size_t count);
+
+void GetDigitBatch(const uint32_t *in, uint8_t *out, std::size_t count, DefIntType index);
+void GetDigitBatch(const uint64_t *in, uint8_t *out, std::size_t count, DefIntType index);
+void GetDigitBatch(const int32_t *in, uint8_t *out, std::size_t count, DefIntType index);
+void GetDigitBatch(const int64_t *in, uint8_t *out, std::size_t count, DefIntType index);
+
+// Fixed width type with same size and sign as T, so long and long long both reach the same kernel
+template<typename T>
+using BatchFixedType = std::conditional_t<sizeof(T) == 4,
+    std::conditional_t<kIsSignedInteger<T>, int32_t, uint32_t>,
+    std::conditional_t<kIsSignedInteger<T>, int64_t, uint64_t>>;
+
+template<typename T>
+constexpr inline bool kHasBatchKernel = kIsInteger<T> && (sizeof(T) == 4 || sizeof(T) == 8);
+} // detail
+
+// Same as out[i] = DigitCount(in[i]) for i in [0, count)
+template<typename T>
+inline void DigitCount(const T *in, uint8_t *out, std::size_t count)
+{
+    if constexpr(detail::kHasBatchKernel<T>)
+        detail::DigitCountBatch(reinterpret_cast<const detail::BatchFixedType<T> *>(in), out, count);
+    else
+    {
+        for(std::size_t i = 0; i < count; i++)
+            out[i] = static_cast<uint8_t>(DigitCount(in[i]));
+    }
+}
+
+// Same as out[i] = GetDigit(in[i], index) for i in [0, count)
+// Sign of value is ignored, so digits of negative numbers are the same as of positive
+// If index is invalid every digit is 0
+template<typename T>
+inline void GetDigit(const T *in, uint8_t *out, std::size_t count, DefIntType index)
+{
+    if constexpr(detail::kHasBatchKernel<T>)
+        detail::GetDigitBatch(reinterpret_cast<const detail::BatchFixedType<T> *>(in), out, count, index);
+    else
+    {
+        for(std::size_t i = 0; i < count; i++)
+        {
+            if constexpr(kIsInteger<T>)
+                out[i] = GetDigit(detail::UnsignedAbs(in[i]), index);
+            else if constexpr(std::is_floating_point_v<T>)
+                out[i] = GetDigit(in[i] < T(0) ? -in[i] : in[i], index);
+            else
+                out[i] = GetDigit(in[i], index);
+        }
+    }
+}
+
+#if __cplusplus >= 202002L
+// Only min(in.size(), out.size()) values are processed
+template<typename T>
+inline void DigitCount(std::span<const T> in, std::span<uint8_t> out)
+{ DigitCount(in.data(), out.data(), std::min(in.size(), out.size())); }
+
+template<typename T>
+inline void GetDigit(std::span<const T> in, std::span<uint8_t> out, DefIntType index)
+{ GetDigit(in.data(), out.data(), std::min(in.size(), out.size()), index); }
+#endif
+} // Tolik
+
+#endif // TOLIK_MATH_BATCH_HPP
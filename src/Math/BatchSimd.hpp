@@ -0,0 +1,132 @@
+#ifndef TOLIK_MATH_BATCH_SIMD_HPP
+#define TOLIK_MATH_BATCH_SIMD_HPP
+
+// Vector helpers shared by runtime dispatched kernels (Math/Batch.cpp, Algorithms/PalindromesBatch.cpp, Algorithms/String.cpp)
+// Every function has its own target attribute, so translation units are compiled without -march
+// and kernels are picked with GetSimdLevel() (see Utilities/Cpu.hpp). Include only from .cpp files
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TOLIK_BATCH_X86
+#define TOLIK_AVX512_TARGET __attribute__((target("avx512f,avx512cd,avx512bw,avx2")))
+
+namespace Tolik
+{
+namespace detail
+{
+// SSE4.2
+
+__attribute__((target("sse4.2"))) inline __m128i MulHiU32(__m128i a, __m128i b)
+{
+	const __m128i even = _mm_srli_epi64(_mm_mul_epu32(a, b), 32);
+	const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_blend_epi16(even, odd, 0xCC);
+}
+
+template<bool IsSigned>
+__attribute__((target("sse4.2"))) inline __m128i LoadMagnitude32SSE42(const void *in)
+{
+	const __m128i value = _mm_loadu_si128(static_cast<const __m128i *>(in));
+	if constexpr(IsSigned)
+		return _mm_abs_epi32(value);
+	else
+		return value;
+}
+
+// AVX2
+
+__attribute__((target("avx2"))) inline __m256i GreaterU64AVX2(__m256i a, __m256i b)
+{
+	const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(1ull << 63));
+	return _mm256_cmpgt_epi64(_mm256_xor_si256(a, bias), _mm256_xor_si256(b, bias));
+}
+
+__attribute__((target("avx2"))) inline __m256i MulHiU32AVX2(__m256i a, __m256i b)
+{
+	const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(a, b), 32);
+	const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+	return _mm256_blend_epi32(even, odd, 0xAA);
+}
+
+__attribute__((target("avx2"))) inline __m256i MulHiU64AVX2(__m256i a, __m256i b)
+{
+	const __m256i low32 = _mm256_set1_epi64x(0xFFFFFFFF);
+	const __m256i aHigh = _mm256_srli_epi64(a, 32);
+	const __m256i bHigh = _mm256_srli_epi64(b, 32);
+	const __m256i lowLow = _mm256_mul_epu32(a, b);
+	const __m256i lowHigh = _mm256_mul_epu32(a, bHigh);
+	const __m256i highLow = _mm256_mul_epu32(aHigh, b);
+	const __m256i highHigh = _mm256_mul_epu32(aHigh, bHigh);
+	const __m256i cross = _mm256_add_epi64(_mm256_add_epi64(_mm256_srli_epi64(lowLow, 32), _mm256_and_si256(lowHigh, low32)), _mm256_and_si256(highLow, low32));
+	return _mm256_add_epi64(_mm256_add_epi64(highHigh, _mm256_srli_epi64(cross, 32)), _mm256_add_epi64(_mm256_srli_epi64(lowHigh, 32), _mm256_srli_epi64(highLow, 32)));
+}
+
+template<bool IsSigned>
+__attribute__((target("avx2"))) inline __m256i LoadMagnitude32AVX2(const void *in)
+{
+	const __m256i value = _mm256_loadu_si256(static_cast<const __m256i *>(in));
+	if constexpr(IsSigned)
+		return _mm256_abs_epi32(value);
+	else
+		return value;
+}
+
+template<bool IsSigned>
+__attribute__((target("avx2"))) inline __m256i LoadMagnitude64AVX2(const void *in)
+{
+	const __m256i value = _mm256_loadu_si256(static_cast<const __m256i *>(in));
+	if constexpr(IsSigned)
+	{
+		const __m256i sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), value);
+		return _mm256_sub_epi64(_mm256_xor_si256(value, sign), sign);
+	}
+	else
+		return value;
+}
+
+// AVX-512
+
+TOLIK_AVX512_TARGET inline __m512i MulHiU32AVX512(__m512i a, __m512i b)
+{
+	const __m512i even = _mm512_srli_epi64(_mm512_mul_epu32(a, b), 32);
+	const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32));
+	return _mm512_mask_blend_epi32(0xAAAA, even, odd);
+}
+
+TOLIK_AVX512_TARGET inline __m512i MulHiU64AVX512(__m512i a, __m512i b)
+{
+	const __m512i low32 = _mm512_set1_epi64(0xFFFFFFFF);
+	const __m512i aHigh = _mm512_srli_epi64(a, 32);
+	const __m512i bHigh = _mm512_srli_epi64(b, 32);
+	const __m512i lowLow = _mm512_mul_epu32(a, b);
+	const __m512i lowHigh = _mm512_mul_epu32(a, bHigh);
+	const __m512i highLow = _mm512_mul_epu32(aHigh, b);
+	const __m512i highHigh = _mm512_mul_epu32(aHigh, bHigh);
+	const __m512i cross = _mm512_add_epi64(_mm512_add_epi64(_mm512_srli_epi64(lowLow, 32), _mm512_and_si512(lowHigh, low32)), _mm512_and_si512(highLow, low32));
+	return _mm512_add_epi64(_mm512_add_epi64(highHigh, _mm512_srli_epi64(cross, 32)), _mm512_add_epi64(_mm512_srli_epi64(lowHigh, 32), _mm512_srli_epi64(highLow, 32)));
+}
+
+template<bool IsSigned>
+TOLIK_AVX512_TARGET inline __m512i LoadMagnitude32AVX512(const void *in)
+{
+	const __m512i value = _mm512_loadu_si512(in);
+	if constexpr(IsSigned)
+		return _mm512_abs_epi32(value);
+	else
+		return value;
+}
+
+template<bool IsSigned>
+TOLIK_AVX512_TARGET inline __m512i LoadMagnitude64AVX512(const void *in)
+{
+	const __m512i value = _mm512_loadu_si512(in);
+	if constexpr(IsSigned)
+		return _mm512_abs_epi64(value);
+	else
+		return value;
+}
+} // detail
+} // Tolik
+#endif
+
+#endif // TOLIK_MATH_BATCH_SIMD_HPP
@@ -0,0 +1,576 @@
+#ifndef TOLIK_MATH_BIG_UINT_HPP
+#define TOLIK_MATH_BIG_UINT_HPP
+
+#include <type_traits>
+#include <array>
+#include <limits>
+#include <cstddef>
+
+#include "Setup.hpp"
+#include "Math/Constants.hpp"
+#include "Math/Utils.hpp"
+#include "Math/Digits.hpp"
+#include "Utilities/Type.hpp"
+
+// Limb products and divisions are done in 128 bits
+#ifdef TOLIK_HAS_INT128
+namespace Tolik
+{
+namespace detail
+{
+// Divisor prepared for division of 128-bit value by 64-bit one with two multiplications instead of div instruction
+// Moller & Granlund, "Improved division by invariant integers", algorithm 4
+struct LimbDivisor
+{
+    uint64_t divisor = 1;
+    // Divisor shifted so that its top bit is set
+    uint64_t normalized = 0;
+    // floor((2^128 - 1) / normalized) - 2^64
+    uint64_t reciprocal = 0;
+    int shift = 0;
+};
+
+// divisor must not be 0
+constexpr inline LimbDivisor MakeLimbDivisor(uint64_t divisor)
+{
+    LimbDivisor result;
+    result.divisor = divisor;
+    result.shift = __builtin_clzll(divisor);
+    result.normalized = divisor << result.shift;
+    result.reciprocal = static_cast<uint64_t>(((static_cast<UInt128>(~result.normalized) << 64) | ~uint64_t(0)) / result.normalized);
+    return result;
+}
+
+// (high * 2^64 + low) / divisor.normalized for high < divisor.normalized, remainder is stored into high
+constexpr inline uint64_t DivideLimb(uint64_t &high, uint64_t low, const LimbDivisor &divisor)
+{
+    const UInt128 product = static_cast<UInt128>(divisor.reciprocal) * high + ((static_cast<UInt128>(high) << 64) | low);
+    uint64_t quotient = static_cast<uint64_t>(product >> 64) + 1;
+    uint64_t remainder = low - quotient * divisor.normalized;
+    // Estimate is off by at most one in either direction
+    // The first correction is taken about half of the time, so it's done with mask instead of branch
+    const uint64_t mask = uint64_t(0) - static_cast<uint64_t>(static_cast<uint64_t>(product) < remainder);
+    quotient += mask;
+    remainder += mask & divisor.normalized;
+    if(divisor.normalized <= remainder)
+    {
+        quotient++;
+        remainder -= divisor.normalized;
+    }
+    high = remainder;
+    return quotient;
+}
+
+// 10^19 is the biggest power of 10 that fits into limb
+constexpr inline std::size_t kMaxLimbPower10 = 19;
+
+constexpr inline std::array<LimbDivisor, kMaxLimbPower10 + 1> MakePower10LimbDivisors()
+{
+    std::array<LimbDivisor, kMaxLimbPower10 + 1> divisors{};
+    uint64_t power = 1;
+    for(std::size_t i = 0; i < divisors.size(); i++)
+    {
+        divisors[i] = MakeLimbDivisor(power);
+        power *= 10;
+    }
+    return divisors;
+}
+
+// kPower10LimbDivisors[i] divides by 10^i
+constexpr inline std::array<LimbDivisor, kMaxLimbPower10 + 1> kPower10LimbDivisors = MakePower10LimbDivisors();
+
+// Built-in integers that fit into one limb, they are multiplied and divided limb by limb instead of as BigUInt
+template<typename T>
+constexpr inline bool kIsLimbOperand = kIsInteger<T> && sizeof(T) <= sizeof(uint64_t);
+} // detail
+
+// Unsigned integer of Limbs 64-bit words, that behaves like built-in unsigned type of Limbs * 64 bits:
+// every operation wraps around modulo 2^(Limbs * 64) and division by 0 is undefined
+// Value is kept in fixed array, so it's never allocated on heap, and every operation is constexpr
+// Multiplication and division by built-in integer (or by BigUInt that fits into one limb) are done limb by limb,
+// division uses precomputed reciprocal instead of div instruction. See also MultiplyPower10 and DividePower10
+// Math and palindrome templates work with it: std::numeric_limits is specialized, and DigitCount and DecomposeDigits are overloaded
+// Example: BigUInt<2> value = MultiplyPower10(BigUInt<2>(12), 30); DigitCount(value) = 32; value % 7 = 5;
+template<std::size_t Limbs>
+class BigUInt
+{
+public:
+    static_assert(Limbs > 0, "BigUInt needs at least one limb");
+    static constexpr inline std::size_t kLimbCount = Limbs;
+    static constexpr inline DefUIntType kBits = Limbs * 64;
+
+    constexpr BigUInt() {}
+    // Implicit as conversion between built-in integers, negative values wrap around
+    template<typename T, std::enable_if_t<kIsInteger<T>, bool> = true>
+    constexpr BigUInt(T value)
+    {
+        uint64_t fill = 0;
+        if constexpr(kIsSignedInteger<T>)
+            fill = value < T(0) ? ~uint64_t(0) : 0;
+        // Signed values are sign extended up to the first limb
+        using WideT = std::conditional_t<(sizeof(T) > sizeof(uint64_t)), UInt128, uint64_t>;
+        const WideT bits = static_cast<WideT>(value);
+        m_limbs[0] = static_cast<uint64_t>(bits);
+        std::size_t first = 1;
+        if constexpr(sizeof(T) > sizeof(uint64_t) && Limbs > 1)
+        {
+            m_limbs[1] = static_cast<uint64_t>(bits >> 64);
+            first = 2;
+        }
+        for(std::size_t i = first; i < Limbs; i++)
+            m_limbs[i] = fill;
+    }
+
+    // Low bits of value, as conversion between built-in integers
+    template<typename T, std::enable_if_t<kIsInteger<T>, bool> = true>
+    constexpr explicit operator T() const
+    {
+        if constexpr(sizeof(T) > sizeof(uint64_t) && Limbs > 1)
+            return static_cast<T>((static_cast<UInt128>(m_limbs[1]) << 64) | m_limbs[0]);
+        else
+            return static_cast<T>(m_limbs[0]);
+    }
+
+    constexpr explicit operator bool() const { return !IsZero(); }
+
+    // Limb 0 is the least significant one
+    constexpr uint64_t GetLimb(std::size_t index) const { return m_limbs[index]; }
+    constexpr void SetLimb(std::size_t index, uint64_t limb) { m_limbs[index] = limb; }
+
+    // Count of limbs up to the highest non-zero one, 0 for 0
+    constexpr std::size_t GetUsedLimbCount() const
+    {
+        std::size_t used = Limbs;
+        while(used != 0 && m_limbs[used - 1] == 0)
+            used--;
+        return used;
+    }
+
+    constexpr bool IsZero() const { return GetUsedLimbCount() == 0; }
+
+    // Number of bits needed to represent (value | 1), same as detail::BitWidth for built-in integers
+    constexpr DefUIntType GetBitWidth() const
+    {
+        const std::size_t used = GetUsedLimbCount();
+        if(used == 0)
+            return 1;
+        return used * 64 - __builtin_clzll(m_limbs[used - 1]);
+    }
+
+    // Same as *this = *this * multiplier, with one multiplication per used limb
+    constexpr BigUInt &MultiplySmall(uint64_t multiplier)
+    {
+        const std::size_t used = GetUsedLimbCount();
+        uint64_t carry = 0;
+        for(std::size_t i = 0; i < used; i++)
+        {
+            const UInt128 product = static_cast<UInt128>(m_limbs[i]) * multiplier + carry;
+            m_limbs[i] = static_cast<uint64_t>(product);
+            carry = static_cast<uint64_t>(product >> 64);
+        }
+        if(used < Limbs)
+            m_limbs[used] = carry;
+        return *this;
+    }
+
+    // Same as DivideSmall(divisor.divisor), but every used limb costs two multiplications with precomputed reciprocal
+    constexpr uint64_t DivideSmall(const detail::LimbDivisor &divisor)
+    {
+        const std::size_t used = GetUsedLimbCount();
+        if(used == 0)
+            return 0;
+
+        // Value is shifted together with divisor, so quotient stays the same and remainder is shifted back
+        const int shift = divisor.shift;
+        uint64_t remainder = shift == 0 ? 0 : m_limbs[used - 1] >> (64 - shift);
+        for(std::size_t i = used; i-- > 0;)
+        {
+            const uint64_t low = shift == 0 ? m_limbs[i] : (m_limbs[i] << shift) | (i == 0 ? 0 : m_limbs[i - 1] >> (64 - shift));
+            m_limbs[i] = detail::DivideLimb(remainder, low, divisor);
+        }
+        return remainder >> shift;
+    }
+
+    // Same as *this = *this / divisor, returns *this % divisor. divisor must not be 0
+    // Preparing reciprocal costs a division itself, so divisor that is used once is divided by limb by limb
+    constexpr uint64_t DivideSmall(uint64_t divisor)
+    {
+        uint64_t remainder = 0;
+        for(std::size_t i = GetUsedLimbCount(); i-- > 0;)
+        {
+            const UInt128 part = (static_cast<UInt128>(remainder) << 64) | m_limbs[i];
+            const uint64_t quotient = static_cast<uint64_t>(part / divisor);
+            remainder = static_cast<uint64_t>(part) - quotient * divisor;
+            m_limbs[i] = quotient;
+        }
+        return remainder;
+    }
+
+    constexpr BigUInt &operator+=(const BigUInt &other)
+    {
+        uint64_t carry = 0;
+        for(std::size_t i = 0; i < Limbs; i++)
+        {
+            const uint64_t sum = m_limbs[i] + other.m_limbs[i];
+            const uint64_t result = sum + carry;
+            carry = (sum < m_limbs[i]) | (result < sum);
+            m_limbs[i] = result;
+        }
+        return *this;
+    }
+
+    constexpr BigUInt &operator-=(const BigUInt &other)
+    {
+        uint64_t borrow = 0;
+        for(std::size_t i = 0; i < Limbs; i++)
+        {
+            const uint64_t difference = m_limbs[i] - other.m_limbs[i];
+            const uint64_t result = difference - borrow;
+            borrow = (m_limbs[i] < other.m_limbs[i]) | (difference < borrow);
+            m_limbs[i] = result;
+        }
+        return *this;
+    }
+
+    constexpr BigUInt &operator*=(const BigUInt &other) { return *this = *this * other; }
+    constexpr BigUInt &operator/=(const BigUInt &other) { return *this = *this / other; }
+    constexpr BigUInt &operator%=(const BigUInt &other) { return *this = *this % other; }
+
+    constexpr BigUInt &operator<<=(DefUIntType shift)
+    {
+        const std::size_t limbShift = shift / 64;
+        const DefUIntType bitShift = shift % 64;
+        for(std::size_t i = Limbs; i-- > 0;)
+        {
+            const uint64_t high = i < limbShift ? 0 : m_limbs[i - limbShift];
+            const uint64_t low = (i < limbShift + 1 || bitShift == 0) ? 0 : m_limbs[i - limbShift - 1];
+            m_limbs[i] = bitShift == 0 ? high : (high << bitShift) | (low >> (64 - bitShift));
+        }
+        return *this;
+    }
+
+    constexpr BigUInt &operator>>=(DefUIntType shift)
+    {
+        const std::size_t limbShift = shift / 64;
+        const DefUIntType bitShift = shift % 64;
+        for(std::size_t i = 0; i < Limbs; i++)
+        {
+            const uint64_t low = i + limbShift < Limbs ? m_limbs[i + limbShift] : 0;
+            const uint64_t high = (i + limbShift + 1 < Limbs && bitShift != 0) ? m_limbs[i + limbShift + 1] : 0;
+            m_limbs[i] = bitShift == 0 ? low : (low >> bitShift) | (high << (64 - bitShift));
+        }
+        return *this;
+    }
+
+    friend constexpr BigUInt operator+(BigUInt a, const BigUInt &b) { return a += b; }
+    friend constexpr BigUInt operator-(BigUInt a, const BigUInt &b) { return a -= b; }
+    friend constexpr BigUInt operator-(const BigUInt &a) { return BigUInt() - a; }
+    friend constexpr BigUInt operator<<(BigUInt a, DefUIntType shift) { return a <<= shift; }
+    friend constexpr BigUInt operator>>(BigUInt a, DefUIntType shift) { return a >>= shift; }
+
+    friend constexpr BigUInt operator*(const BigUInt &a, const BigUInt &b)
+    {
+        const std::size_t usedA = a.GetUsedLimbCount();
+        const std::size_t usedB = b.GetUsedLimbCount();
+        if(usedB <= 1)
+            return BigUInt(a).MultiplySmall(b.m_limbs[0]);
+        if(usedA <= 1)
+            return BigUInt(b).MultiplySmall(a.m_limbs[0]);
+
+        // Schoolbook multiplication, limbs past Limbs are dropped
+        BigUInt result;
+        for(std::size_t i = 0; i < usedA; i++)
+        {
+            uint64_t carry = 0;
+            const std::size_t last = usedB < Limbs - i ? usedB : Limbs - i;
+            for(std::size_t j = 0; j < last; j++)
+            {
+                const UInt128 product = static_cast<UInt128>(a.m_limbs[i]) * b.m_limbs[j] + result.m_limbs[i + j] + carry;
+                result.m_limbs[i + j] = static_cast<uint64_t>(product);
+                carry = static_cast<uint64_t>(product >> 64);
+            }
+            if(i + last < Limbs)
+                result.m_limbs[i + last] = carry;
+        }
+        return result;
+    }
+
+    friend constexpr BigUInt operator/(const BigUInt &a, const BigUInt &b)
+    {
+        if(b.GetUsedLimbCount() <= 1)
+            return a / b.m_limbs[0];
+        BigUInt quotient;
+        DivideModulo(a, b, &quotient, nullptr);
+        return quotient;
+    }
+
+    friend constexpr BigUInt operator%(const BigUInt &a, const BigUInt &b)
+    {
+        if(b.GetUsedLimbCount() <= 1)
+            return a % b.m_limbs[0];
+        BigUInt remainder;
+        DivideModulo(a, b, nullptr, &remainder);
+        return remainder;
+    }
+
+    // Built-in integer operands are exact match, so they are preferred to conversion into BigUInt
+    // Negative ones are still converted, because they are huge in unsigned arithmetic
+    template<typename T, std::enable_if_t<detail::kIsLimbOperand<T>, bool> = true>
+    friend constexpr BigUInt operator*(BigUInt a, T b)
+    {
+        if(IsNegative(b))
+            return a * BigUInt(b);
+        return a.MultiplySmall(static_cast<uint64_t>(b));
+    }
+
+    template<typename T, std::enable_if_t<detail::kIsLimbOperand<T>, bool> = true>
+    friend constexpr BigUInt operator*(T a, BigUInt b) { return b * a; }
+
+    template<typename T, std::enable_if_t<detail::kIsLimbOperand<T>, bool> = true>
+    friend constexpr BigUInt operator/(BigUInt a, T b)
+    {
+        if(IsNegative(b))
+            return a / BigUInt(b);
+        a.DivideSmall(static_cast<uint64_t>(b));
+        return a;
+    }
+
+    template<typename T, std::enable_if_t<detail::kIsLimbOperand<T>, bool> = true>
+    friend constexpr BigUInt operator%(BigUInt a, T b)
+    {
+        if(IsNegative(b))
+            return a % BigUInt(b);
+        return BigUInt(a.DivideSmall(static_cast<uint64_t>(b)));
+    }
+
+    friend constexpr bool operator==(const BigUInt &a, const BigUInt &b)
+    {
+        for(std::size_t i = 0; i < Limbs; i++)
+            if(a.m_limbs[i] != b.m_limbs[i])
+                return false;
+        return true;
+    }
+
+    friend constexpr bool operator<(const BigUInt &a, const BigUInt &b)
+    {
+        for(std::size_t i = Limbs; i-- > 0;)
+            if(a.m_limbs[i] != b.m_limbs[i])
+                return a.m_limbs[i] < b.m_limbs[i];
+        return false;
+    }
+
+    friend constexpr bool operator!=(const BigUInt &a, const BigUInt &b) { return !(a == b); }
+    friend constexpr bool operator>(const BigUInt &a, const BigUInt &b) { return b < a; }
+    friend constexpr bool operator<=(const BigUInt &a, const BigUInt &b) { return !(b < a); }
+    friend constexpr bool operator>=(const BigUInt &a, const BigUInt &b) { return !(a < b); }
+
+private:
+    template<typename T>
+    static constexpr bool IsNegative(T value)
+    {
+        if constexpr(kIsSignedInteger<T>)
+            return value < T(0);
+        else
+            return false;
+    }
+
+    // Long division by divisor of at least two limbs
+    // Knuth, "The Art of Computer Programming" vol. 2, 4.3.1 algorithm D
+    static constexpr void DivideModulo(const BigUInt &dividend, const BigUInt &divisor, BigUInt *quotient, BigUInt *remainder)
+    {
+        const std::size_t n = divisor.GetUsedLimbCount();
+        const std::size_t m = dividend.GetUsedLimbCount();
+        if(dividend < divisor)
+        {
+            if(quotient != nullptr)
+                *quotient = BigUInt();
+            if(remainder != nullptr)
+                *remainder = dividend;
+            return;
+        }
+
+        // Divisor is shifted until its top bit is set, so that every quotient digit estimate is off by at most 2
+        const int shift = __builtin_clzll(divisor.m_limbs[n - 1]);
+        const BigUInt v = divisor << shift;
+        uint64_t u[Limbs + 1] = {};
+        u[m] = shift == 0 ? 0 : dividend.m_limbs[m - 1] >> (64 - shift);
+        for(std::size_t i = m; i-- > 0;)
+            u[i] = shift == 0 ? dividend.m_limbs[i] : (dividend.m_limbs[i] << shift) | (i == 0 ? 0 : dividend.m_limbs[i - 1] >> (64 - shift));
+
+        BigUInt result;
+        const uint64_t top = v.m_limbs[n - 1];
+        const uint64_t second = v.m_limbs[n - 2];
+        for(std::size_t j = m - n + 1; j-- > 0;)
+        {
+            const UInt128 numerator = (static_cast<UInt128>(u[j + n]) << 64) | u[j + n - 1];
+            UInt128 estimate = numerator / top;
+            UInt128 rest = numerator - estimate * top;
+            while((estimate >> 64) != 0 || estimate * second > ((rest << 64) | u[j + n - 2]))
+            {
+                estimate--;
+                rest += top;
+                if((rest >> 64) != 0)
+                    break;
+            }
+
+            // u[j, j + n] -= estimate * v
+            uint64_t carry = 0;
+            uint64_t borrow = 0;
+            for(std::size_t i = 0; i < n; i++)
+            {
+                const UInt128 product = estimate * v.m_limbs[i] + carry;
+                carry = static_cast<uint64_t>(product >> 64);
+                const uint64_t low = static_cast<uint64_t>(product);
+                const uint64_t difference = u[i + j] - low;
+                const uint64_t nextBorrow = (u[i + j] < low) | (difference < borrow);
+                u[i + j] = difference - borrow;
+                borrow = nextBorrow;
+            }
+            const uint64_t difference = u[j + n] - carry;
+            const bool negative = (u[j + n] < carry) | (difference < borrow);
+            u[j + n] = difference - borrow;
+
+            // Estimate was one too big, so divisor is added back
+            if(negative)
+            {
+                estimate--;
+                carry = 0;
+                for(std::size_t i = 0; i < n; i++)
+                {
+                    const UInt128 sum = static_cast<UInt128>(u[i + j]) + v.m_limbs[i] + carry;
+                    u[i + j] = static_cast<uint64_t>(sum);
+                    carry = static_cast<uint64_t>(sum >> 64);
+                }
+                u[j + n] += carry;
+            }
+            result.m_limbs[j] = static_cast<uint64_t>(estimate);
+        }
+
+        if(quotient != nullptr)
+            *quotient = result;
+        if(remainder != nullptr)
+        {
+            BigUInt shifted;
+            for(std::size_t i = 0; i < n; i++)
+                shifted.m_limbs[i] = u[i];
+            *remainder = shifted >> shift;
+        }
+    }
+
+    uint64_t m_limbs[Limbs] = {};
+};
+} // Tolik
+
+namespace std
+{
+template<std::size_t Limbs>
+class numeric_limits<Tolik::BigUInt<Limbs>>
+{
+public:
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = false;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true;
+    static constexpr int radix = 2;
+    static constexpr int digits = Limbs * 64;
+    // 1233 / 4096 is close enough to log10(2) for any reasonable width
+    static constexpr int digits10 = (digits * 1233) >> 12;
+
+    static constexpr Tolik::BigUInt<Limbs> min() { return Tolik::BigUInt<Limbs>(); }
+    static constexpr Tolik::BigUInt<Limbs> lowest() { return Tolik::BigUInt<Limbs>(); }
+    static constexpr Tolik::BigUInt<Limbs> max() { return Tolik::BigUInt<Limbs>() - Tolik::BigUInt<Limbs>(1u); }
+};
+} // std
+
+namespace Tolik
+{
+namespace detail
+{
+template<std::size_t Limbs>
+constexpr inline std::size_t kBigUIntPower10Size = std::numeric_limits<BigUInt<Limbs>>::digits10 + 1;
+
+template<std::size_t Limbs>
+constexpr inline std::array<BigUInt<Limbs>, kBigUIntPower10Size<Limbs>> MakeBigUIntPower10()
+{
+    std::array<BigUInt<Limbs>, kBigUIntPower10Size<Limbs>> powers{};
+    BigUInt<Limbs> power = 1u;
+    for(std::size_t i = 0; i < powers.size(); i++)
+    {
+        powers[i] = power;
+        power.MultiplySmall(10);
+    }
+    return powers;
+}
+
+// kBigUIntPower10<Limbs>[i] = 10^i for every 10^i that fits into BigUInt<Limbs>
+template<std::size_t Limbs>
+constexpr inline std::array<BigUInt<Limbs>, kBigUIntPower10Size<Limbs>> kBigUIntPower10 = MakeBigUIntPower10<Limbs>();
+
+// FastPower10<BigUInt<Limbs>> reads kBigUIntPower10
+template<std::size_t Limbs>
+struct Power10Lookup<BigUInt<Limbs>> : std::true_type
+{ static constexpr inline const std::array<BigUInt<Limbs>, kBigUIntPower10Size<Limbs>> &kTable = kBigUIntPower10<Limbs>; };
+
+// Digits are split in blocks of 16, so that every block is decomposed as 64-bit integer
+template<std::size_t Limbs>
+struct DecomposeBufferSize<BigUInt<Limbs>, false>
+{ static constexpr inline std::size_t value = (kMaxDigits<BigUInt<Limbs>> + 15) / 16 * 16; };
+} // detail
+
+// number * 10^exp, with one multiplication per limb for every 19 digits
+template<std::size_t Limbs, typename U>
+constexpr inline BigUInt<Limbs> MultiplyPower10(BigUInt<Limbs> number, U exp)
+{
+    for(; U(detail::kMaxLimbPower10) < exp && !number.IsZero(); exp = exp - U(detail::kMaxLimbPower10))
+        number.MultiplySmall(detail::kPower10LimbDivisors[detail::kMaxLimbPower10].divisor);
+    if(U(0) < exp)
+        number.MultiplySmall(detail::kPower10LimbDivisors[static_cast<std::size_t>(exp)].divisor);
+    return number;
+}
+
+// Same as DividePower10 for built-in integers: number / 10^exp, number is returned for negative exp
+// Division by up to 10^19 is one pass over limbs with precomputed reciprocal
+template<std::size_t Limbs, typename U>
+constexpr inline BigUInt<Limbs> DividePower10(BigUInt<Limbs> number, U exp)
+{
+    if(exp < U(0))
+        return number;
+    for(; U(detail::kMaxLimbPower10) < exp && !number.IsZero(); exp = exp - U(detail::kMaxLimbPower10))
+        number.DivideSmall(detail::kPower10LimbDivisors[detail::kMaxLimbPower10]);
+    if(U(0) < exp)
+        number.DivideSmall(detail::kPower10LimbDivisors[static_cast<std::size_t>(exp)]);
+    return number;
+}
+
+// Same as DigitCount for built-in integers: bit width and one comparison with power of 10, 0 = 0 digits
+template<typename T = DefUIntType, std::size_t Limbs>
+constexpr inline T DigitCount(const BigUInt<Limbs> &number)
+{
+    const DefUIntType approximation = (number.GetBitWidth() * 1233) >> 12;
+    return static_cast<T>(approximation + (detail::kBigUIntPower10<Limbs>[approximation] <= number));
+}
+
+// Same as DecomposeDigits for built-in integers: whole kDecomposeBufferSize buffer is written, digits past count are 0
+// Number is split in blocks of 16 digits, one division by 10^16 per block
+template<std::size_t Limbs>
+constexpr inline DefUIntType DecomposeDigits(BigUInt<Limbs> number, uint8_t *buffer)
+{
+    constexpr std::size_t kBlocks = kDecomposeBufferSize<BigUInt<Limbs>> / 16;
+    const DefUIntType count = DigitCount(number);
+    for(std::size_t i = 0; i < kBlocks; i++)
+    {
+        uint64_t words[2] = {};
+        if(!number.IsZero())
+            detail::DecomposeSixteenDigits(number.DivideSmall(detail::kPower10LimbDivisors[16]), words);
+        detail::StoreDigitWord(words[0], buffer + i * 16);
+        detail::StoreDigitWord(words[1], buffer + i * 16 + 8);
+    }
+    return count;
+}
+} // Tolik
+
+#endif // TOLIK_HAS_INT128
+
+#endif // TOLIK_MATH_BIG_UINT_HPP
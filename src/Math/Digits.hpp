@@ -0,0 +1,218 @@
+#ifndef TOLIK_MATH_DIGITS_HPP
+#define TOLIK_MATH_DIGITS_HPP
+
+#include <type_traits>
+#include <array>
+
+#include "Setup.hpp"
+#include "Math/Constants.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Type.hpp"
+
+namespace Tolik
+{
+namespace detail
+{
+// Digits of value < 10^8 packed into bytes of word, least significant digit in the lowest byte
+// Every step splits all lanes at once with multiply-shift, so it's 8 digits without division or lookup
+constexpr inline uint64_t EightDigitsToWord(uint32_t value)
+{
+    // value / 10^4, exact for value < 10^8
+    const uint32_t high = static_cast<uint32_t>((static_cast<uint64_t>(value) * 109951163) >> 40);
+    // Two 32-bit lanes of 4 digits
+    uint64_t word = (value - high * 10000) | (static_cast<uint64_t>(high) << 32);
+    // lane / 100 for lanes < 10^4, gives four 16-bit lanes of 2 digits
+    const uint64_t hundreds = ((word * 10486) >> 20) & 0x0000007F0000007Full;
+    word = (word - hundreds * 100) | (hundreds << 16);
+    // lane / 10 for lanes < 100, gives eight 8-bit lanes of 1 digit
+    const uint64_t tens = ((word * 103) >> 10) & 0x000F000F000F000Full;
+    return (word - tens * 10) | (tens << 8);
+}
+
+// Byte by byte, so it works in constant expressions. Compiler merges it into one store or load
+constexpr inline void StoreDigitWord(uint64_t word, uint8_t *out)
+{
+#pragma GCC unroll 8
+    for(int i = 0; i < 8; i++)
+        out[i] = static_cast<uint8_t>(word >> (i * 8));
+}
+
+constexpr inline uint64_t LoadDigitWord(const uint8_t *in)
+{
+    uint64_t word = 0;
+#pragma GCC unroll 8
+    for(int i = 0; i < 8; i++)
+        word |= static_cast<uint64_t>(in[i]) << (i * 8);
+    return word;
+}
+
+// Exactly 16 digits of value < 10^16 in 2 words
+constexpr inline void DecomposeSixteenDigits(uint64_t value, uint64_t *words)
+{
+    // Division by constant is compiled to multiply and shift
+    const uint64_t high = value / 100000000;
+    words[0] = EightDigitsToWord(static_cast<uint32_t>(value - high * 100000000));
+    words[1] = EightDigitsToWord(static_cast<uint32_t>(high));
+}
+
+// Exactly 24 digits of value < 2^64 in 3 words
+constexpr inline void DecomposeTwentyFourDigits(uint64_t value, uint64_t *words)
+{
+    const uint64_t high = value / 10000000000000000ull;
+    DecomposeSixteenDigits(value - high * 10000000000000000ull, words);
+    words[2] = EightDigitsToWord(static_cast<uint32_t>(high));
+}
+
+#ifdef TOLIK_HAS_INT128
+// Exactly 40 digits of value < 2^128 in 5 words
+constexpr inline void DecomposeFortyDigits(UInt128 value, uint64_t *words)
+{
+    // There is no multiply-shift for 128-bit constant division, so it's done only twice in 16 digit steps
+    constexpr uint64_t kPower16 = 10000000000000000ull;
+    const UInt128 high = value / kPower16;
+    DecomposeSixteenDigits(static_cast<uint64_t>(value - high * kPower16), words);
+    const UInt128 top = high / kPower16;
+    DecomposeSixteenDigits(static_cast<uint64_t>(high - top * kPower16), words + 2);
+    words[4] = EightDigitsToWord(static_cast<uint32_t>(top));
+}
+#endif
+
+template<typename T, bool = kIsInteger<T>>
+struct DecomposeBufferSize
+{ static constexpr inline std::size_t value = kMaxDigits<T>; };
+
+// Integers are decomposed in fixed blocks of 8 digits, so no branch depends on digit count
+template<typename T>
+struct DecomposeBufferSize<T, true>
+{ static constexpr inline std::size_t value = sizeof(T) <= 2 ? 8 : sizeof(T) <= 4 ? 16 : sizeof(T) <= 8 ? 24 : 40; };
+} // detail
+
+// Size of buffer needed for DecomposeDigits
+// Floating-point values are decomposed as long long
+template<typename T>
+constexpr inline std::size_t kDecomposeBufferSize = detail::DecomposeBufferSize<std::conditional_t<std::is_floating_point_v<T>, long long, T>>::value;
+
+namespace detail
+{
+// Zero padded digits of integer magnitude packed 8 per word, see EightDigitsToWord
+template<typename T>
+constexpr inline void DecomposeDigitWords(T magnitude, uint64_t *words)
+{
+    if constexpr(sizeof(T) <= 2)
+        words[0] = EightDigitsToWord(magnitude);
+    else if constexpr(sizeof(T) <= 4)
+        DecomposeSixteenDigits(magnitude, words);
+    else if constexpr(sizeof(T) <= 8)
+        DecomposeTwentyFourDigits(magnitude, words);
+    else
+        DecomposeFortyDigits(magnitude, words);
+}
+} // detail
+
+// Writes decimal digits of value into buffer and returns their count
+// Digits are stored least significant first, so buffer[i] == GetDigit(value, i)
+// buffer must have room for kDecomposeBufferSize<T> digits
+// For integers every digit after count is written as 0 too, so whole buffer can be read without checks
+// Sign is ignored and 0 has 0 digits, same as in DigitCount
+// Integers are decomposed 8 digits at a time with multiply-shift instead of division per digit, without branches
+// If value is floating point, fraction part is ignored by casting value to long long
+template<typename T>
+constexpr inline DefUIntType DecomposeDigits(T value, uint8_t *buffer)
+{
+    if constexpr(std::is_floating_point_v<T>)
+        return DecomposeDigits(static_cast<long long>(value), buffer);
+    else if constexpr(kIsInteger<T>)
+    {
+        const MakeUnsignedT<T> magnitude = detail::UnsignedAbs(value);
+        uint64_t words[kDecomposeBufferSize<T> / 8] = {};
+        detail::DecomposeDigitWords(magnitude, words);
+        for(std::size_t i = 0; i < kDecomposeBufferSize<T> / 8; i++)
+            detail::StoreDigitWord(words[i], buffer + i * 8);
+        return DigitCount(magnitude);
+    }
+    else
+    {
+        // Custom types only need '<' '/' '%', and only count digits are written
+        if(value < T(0))
+            value = T(0) - value;
+        DefUIntType count = 0;
+        while(T(0) < value)
+        {
+            buffer[count++] = static_cast<uint8_t>(value % T(10));
+            value = value / T(10);
+        }
+        return count;
+    }
+}
+
+
+// Digits of number decomposed once, so that digit predicates don't divide number again for every digit
+// Indexing is the same as in GetDigit: index 0 is the least significant digit
+// Digits are kept packed 8 per word, so they can be compared by whole words
+// Example: DigitView view(1234); view[0] == 4; view.GetDigitCount() == 4;
+template<typename T>
+class DigitView
+{
+public:
+    // Count of words holding digits, every digit past GetDigitCount() is 0
+    static constexpr inline std::size_t kWordCount = (kDecomposeBufferSize<T> + 7) / 8;
+
+    constexpr DigitView() {}
+    constexpr explicit DigitView(T number) : m_negative(number < T(0))
+    {
+        if constexpr(kIsInteger<T>)
+        {
+            const MakeUnsignedT<T> magnitude = detail::UnsignedAbs(number);
+            detail::DecomposeDigitWords(magnitude, m_words);
+            m_count = DigitCount(magnitude);
+        }
+        else
+        {
+            uint8_t digits[kWordCount * 8] = {};
+            m_count = DecomposeDigits(number, digits);
+            for(std::size_t i = 0; i < kWordCount; i++)
+                m_words[i] = detail::LoadDigitWord(digits + i * 8);
+        }
+    }
+
+    // Index must be less than kWordCount * 8
+    inline constexpr uint8_t operator[](DefUIntType index) const { return static_cast<uint8_t>(m_words[index / 8] >> (index % 8 * 8)); }
+
+    // If index is invalid 0 returned, same as in GetDigit
+    template<typename U>
+    inline constexpr uint8_t GetDigit(U index) const { return (index < U(0) || U(m_count) <= index) ? 0 : (*this)[index]; }
+
+    // Digits [index * 8, index * 8 + 8) in bytes of word, the lowest byte is the least significant digit
+    inline constexpr uint64_t GetDigitWord(std::size_t index) const { return m_words[index]; }
+
+    inline constexpr DefUIntType GetDigitCount() const { return m_count; }
+    inline constexpr bool IsNegative() const { return m_negative; }
+
+private:
+    uint64_t m_words[kWordCount] = {};
+    DefUIntType m_count = 0;
+    bool m_negative = false;
+};
+
+
+// Same as GetDigitSubstring(number, first, last) for number that view was made from
+template<typename T, typename U>
+constexpr inline T GetDigitSubstring(const DigitView<T> &view, U first, U last)
+{
+    if(first < 0)
+        first = 0;
+    if(last < 0)
+        return 0;
+    if(U(view.GetDigitCount()) < last)
+        last = U(view.GetDigitCount());
+    if(first >= last)
+        return 0;
+
+    T result = T(0);
+    for(U i = last; first < i; i = i - U(1))
+        result = result * T(10) + T(view[i - U(1)]);
+    return view.IsNegative() ? T(0) - result : result;
+}
+} // Tolik
+
+#endif // TOLIK_MATH_DIGITS_HPP
@@ -0,0 +1,67 @@
+#ifndef TOLIK_MATH_FLOAT_HPP
+#define TOLIK_MATH_FLOAT_HPP
+
+#include <type_traits>
+#include <cmath>
+#include <string_view>
+
+#include "Setup.hpp"
+#include "Math/Constants.hpp"
+#include "Math/Utils.hpp"
+
+// Exact conversions between binary floating point and decimal
+// Implemented in Math/Float.cpp with one table of 128-bit powers of ten
+
+namespace Tolik
+{
+// Finite value in decimal form: significand * 10^exponent
+struct DecimalFloat
+{
+    uint64_t significand = 0;
+    int exponent = 0;
+};
+
+// Shortest decimal that is converted back to exactly the same value, sign is ignored
+// If there are several of them, the closest to value is picked (same digits as std::to_chars gives)
+// Significand has no trailing zeros, 0 = { 0, 0 }
+// Value must be finite
+// Schubfach algorithm: R. Giulietti, "The Schubfach way to render doubles"
+DecimalFloat ToShortestDecimal(double value);
+DecimalFloat ToShortestDecimal(float value);
+
+namespace detail
+{
+// Nearest value to significand * 10^exponent, with ties to even
+// If significand was truncated (there were more non-zero digits after it), truncated must be true
+// Eisel-Lemire algorithm: D. Lemire, "Number Parsing at a Gigabyte per Second"
+// Returns false if result can't be decided from 128-bit product, result isn't changed then
+bool DecimalToFloat(uint64_t significand, int exponent, bool truncated, double &result);
+bool DecimalToFloat(uint64_t significand, int exponent, bool truncated, float &result);
+
+// Correctly rounded value of unsigned text, for rare inputs that DecimalToFloat can't decide
+// Same as strtod/strtof in "C" locale, locale of program doesn't change it
+double ParseFloatFallback(std::string_view text, double);
+float ParseFloatFallback(std::string_view text, float);
+} // detail
+
+// Count of digits after decimal point in shortest decimal form of number, the one that is printed by WriteDecimal
+// 0 for integers, infinities and NaN
+// Example: DigitCountAfterPoint(0.1) = 1; DigitCountAfterPoint(1.25e-3) = 5; DigitCountAfterPoint(1e20) = 0;
+// Binary value of 0.1 is not exactly 0.1, but 0.1 is the shortest decimal that is converted back to it
+template<typename T = DefUIntType, typename U>
+inline T DigitCountAfterPoint(U number)
+{
+    if constexpr(std::is_floating_point_v<U>)
+    {
+        if(!std::isfinite(number))
+            return T(0);
+        using FloatT = std::conditional_t<std::is_same_v<U, float>, float, double>;
+        const DecimalFloat decimal = ToShortestDecimal(static_cast<FloatT>(number));
+        return decimal.exponent < 0 ? static_cast<T>(-decimal.exponent) : T(0);
+    }
+    else
+        return T(0);
+}
+} // Tolik
+
+#endif // TOLIK_MATH_FLOAT_HPP
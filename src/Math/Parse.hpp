@@ -0,0 +1,348 @@
+#ifndef TOLIK_MATH_PARSE_HPP
+#define TOLIK_MATH_PARSE_HPP
+
+#include <type_traits>
+#include <string_view>
+#include <limits>
+#include <algorithm>
+
+#include "Setup.hpp"
+#include "Math/Constants.hpp"
+#include "Math/Utils.hpp"
+#include "Math/Float.hpp"
+#include "Utilities/Type.hpp"
+
+namespace Tolik
+{
+enum class ParseStatus : uint8_t
+{
+    kOk = 0,
+    // Text doesn't start with a number
+    kInvalid,
+    // Number doesn't fit into type, every digit is still consumed
+    kOverflow
+};
+
+template<typename T>
+struct ParseResult
+{
+    T value = T(0);
+    // Count of chars consumed, including '-'
+    std::size_t length = 0;
+    ParseStatus status = ParseStatus::kInvalid;
+};
+
+namespace detail
+{
+constexpr inline uint64_t kEightZeroChars = 0x3030303030303030ull;
+
+// Next 8 chars of text in bytes of word, first char in the lowest byte
+// Chars past the end of text are 0, so they never count as digits
+constexpr inline uint64_t LoadEightChars(std::string_view text, std::size_t position)
+{
+    uint64_t word = 0;
+    if(text.size() - position >= 8)
+    {
+        // Byte loop isn't merged into one load inside of other loops, so memcpy is used outside of constant evaluation
+        if(!__builtin_is_constant_evaluated() && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+        {
+            __builtin_memcpy(&word, text.data() + position, 8);
+            return word;
+        }
+#pragma GCC unroll 8
+        for(int i = 0; i < 8; i++)
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(text[position + i])) << (i * 8);
+    }
+    else
+    {
+        for(std::size_t i = 0; position + i < text.size(); i++)
+            word |= static_cast<uint64_t>(static_cast<uint8_t>(text[position + i])) << (i * 8);
+    }
+    return word;
+}
+
+// Count of digits at the start of word
+// Byte is a digit if its high nibble is 3 and adding 6 doesn't change it
+// Carry from invalid byte might spoil only bytes after it, so the first invalid byte is always found
+constexpr inline DefUIntType CountLeadingDigitChars(uint64_t word)
+{
+    const uint64_t invalid = ((word & 0xF0F0F0F0F0F0F0F0ull) | (((word + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) ^ 0x3333333333333333ull;
+    return invalid == 0 ? 8 : __builtin_ctzll(invalid) >> 3;
+}
+
+// Value of 8 digit chars, first char is the most significant digit
+// Neighbour digits are combined in every lane at once: 8 x 1 digit -> 4 x 2 -> 2 x 4 -> 1 x 8
+constexpr inline uint32_t ParseEightDigitChars(uint64_t word)
+{
+    word = word - kEightZeroChars;
+    word = (word * 10 + (word >> 8)) & 0x00FF00FF00FF00FFull;
+    word = (word * 100 + (word >> 16)) & 0x0000FFFF0000FFFFull;
+    return static_cast<uint32_t>((word * 10000 + (word >> 32)) & 0xFFFFFFFFull);
+}
+
+// Value of first count (1..8) digit chars of word
+// Digits are moved to the top of word and zeros are put before them
+constexpr inline uint32_t ParseDigitChars(uint64_t word, DefUIntType count)
+{
+    const DefUIntType shift = (8 - count) * 8;
+    // Shift in two steps, because shift by 64 is undefined
+    return ParseEightDigitChars((word << shift) | ((kEightZeroChars >> 1) >> (63 - shift)));
+}
+
+// 32-bit and smaller values are accumulated in 64 bits, so that a whole block always fits
+template<typename T>
+using ParseAccumulatorType = std::conditional_t<sizeof(T) <= 4, uint64_t, MakeUnsignedT<T>>;
+
+// value * 10^count + block, returns false on overflow
+// If result surely has less than kMaxDigits digits, overflow isn't checked at all
+template<typename T>
+constexpr inline bool AppendDigitBlock(T &value, uint64_t block, DefUIntType count)
+{
+    constexpr int kSafeDigits = kMaxDigits<T> - 1;
+    const int safeExponent = kSafeDigits - static_cast<int>(count);
+    if(0 <= safeExponent && value < kDigitCountPowers<T>[safeExponent])
+    {
+        value = value * kDigitCountPowers<T>[count] + T(block);
+        return true;
+    }
+    return !__builtin_mul_overflow(value, kDigitCountPowers<T>[count], &value) && !__builtin_add_overflow(value, T(block), &value);
+}
+
+// 64-bit significand holds any 19 digits
+constexpr inline DefUIntType kMaxSignificandDigits = 19;
+
+// Digits of floating-point number collected as significand * 10^exponent
+struct DecimalDigits
+{
+    uint64_t significand = 0;
+    // Count of digits in significand, leading zeros aren't counted
+    DefUIntType count = 0;
+    // Count of digits after kMaxSignificandDigits that didn't fit
+    DefUIntType dropped = 0;
+    // Some of dropped digits weren't 0
+    bool truncated = false;
+};
+
+// Appends run of digit chars starting at position, returns count of chars in it
+// Digits are taken 8 at a time (see ParseDigitChars), the ones that don't fit are only checked for being 0
+// Leading zeros must be skipped before, so that they don't take space in significand
+inline std::size_t AppendSignificandDigits(std::string_view text, std::size_t position, DecimalDigits &digits)
+{
+    const std::size_t start = position;
+    DefUIntType count = 8;
+    while(count == 8)
+    {
+        const uint64_t word = LoadEightChars(text, position);
+        count = CountLeadingDigitChars(word);
+        const DefUIntType taken = std::min<DefUIntType>(count, kMaxSignificandDigits - digits.count);
+        if(taken > 0)
+        {
+            digits.significand = digits.significand * kDigitCountPowers<uint64_t>[taken] + ParseDigitChars(word, taken);
+            digits.count += taken;
+        }
+        for(DefUIntType i = taken; i < count; i++)
+            digits.truncated |= text[position + i] != '0';
+        digits.dropped += count - taken;
+        position += count;
+    }
+    return position - start;
+}
+
+inline std::size_t SkipZeroChars(std::string_view text, std::size_t position)
+{
+    while(position < text.size() && text[position] == '0')
+        position++;
+    return position;
+}
+
+inline bool StartsWithIgnoreCase(std::string_view text, std::string_view prefix)
+{
+    if(text.size() < prefix.size())
+        return false;
+    for(std::size_t i = 0; i < prefix.size(); i++)
+    {
+        if((text[i] | 0x20) != prefix[i])
+            return false;
+    }
+    return true;
+}
+} // detail
+
+// Parses integer from the start of text, like std::from_chars
+// Only digits and '-' (for signed types) are accepted, there is no whitespace skipping and no '+'
+// 8 digits are checked and parsed at once in 64-bit word (SWAR), so long numbers take only few steps
+// On kOverflow every digit is consumed and value is 0
+// Example: ParseInteger<int>("-123 45") = { -123, 4, kOk }
+template<typename T>
+constexpr inline ParseResult<T> ParseInteger(std::string_view text)
+{
+    static_assert(kIsInteger<T>, "ParseInteger expects integer type");
+    using UnsignedT = MakeUnsignedT<T>;
+    using AccumulatorT = detail::ParseAccumulatorType<T>;
+
+    ParseResult<T> result;
+    std::size_t position = 0;
+    bool negative = false;
+    if constexpr(kIsSignedInteger<T>)
+    {
+        if(!text.empty() && text[0] == '-')
+        {
+            negative = true;
+            position = 1;
+        }
+    }
+
+    // Most numbers are shorter than 8 digits, so they are parsed in one step without loop
+    uint64_t word = detail::LoadEightChars(text, position);
+    DefUIntType count = detail::CountLeadingDigitChars(word);
+    if(count == 0)
+        return result;
+    AccumulatorT value = detail::ParseDigitChars(word, count);
+    position += count;
+
+    bool overflow = false;
+    while(count == 8)
+    {
+        word = detail::LoadEightChars(text, position);
+        count = detail::CountLeadingDigitChars(word);
+        if(count == 0)
+            break;
+        overflow |= !detail::AppendDigitBlock(value, detail::ParseDigitChars(word, count), count);
+        position += count;
+    }
+
+    // Negative values can go one past maximum
+    const UnsignedT limit = static_cast<UnsignedT>(std::numeric_limits<T>::max()) + UnsignedT(negative ? 1 : 0);
+    result.length = position;
+    if(overflow || AccumulatorT(limit) < value)
+    {
+        result.status = ParseStatus::kOverflow;
+        return result;
+    }
+
+    const UnsignedT magnitude = static_cast<UnsignedT>(value);
+    result.value = negative ? static_cast<T>(UnsignedT(0) - magnitude) : static_cast<T>(magnitude);
+    result.status = ParseStatus::kOk;
+    return result;
+}
+
+// Calls callback(value) for every integer in text, that are separated by any other chars
+// Replacement for SplitString + std::stoll, without copying every number into separate string
+// Numbers that don't fit into T are skipped, for unsigned T negative numbers don't fit either
+// Example: ParseIntegers<int>("1, -2\n3", callback) calls callback(1); callback(-2); callback(3);
+template<typename T, typename Functor>
+constexpr inline void ParseIntegers(std::string_view text, Functor callback)
+{
+    std::size_t position = 0;
+    while(position < text.size())
+    {
+        const ParseResult<T> parsed = ParseInteger<T>(text.substr(position));
+        if(parsed.status == ParseStatus::kOk)
+            callback(parsed.value);
+        if(parsed.length != 0)
+        {
+            // Number is skipped whole
+            position += parsed.length;
+            continue;
+        }
+        // Unsigned T stops at '-', so digits after it are skipped here instead of being parsed as positive number
+        if constexpr(!kIsSignedInteger<T>)
+        {
+            if(text[position] == '-')
+                position += ParseInteger<T>(text.substr(position + 1)).length;
+        }
+        // Separator is skipped by one char
+        position++;
+    }
+}
+
+// Parses floating-point number from the start of text, like std::from_chars with std::chars_format::general
+// Accepted: [-]digits[.digits][(e|E)[+|-]digits], digits may be missing on one side of the point; "inf", "infinity", "nan" in any case
+// First 19 significant digits are parsed 8 at a time and converted by Eisel-Lemire algorithm (see Math/Float.hpp),
+// only numbers extremely close to halfway between two floats fall back to strtod
+// On kOverflow value is infinity with sign of number, numbers below the smallest subnormal become 0
+// Example: ParseFloat<double>("-1.5e3,") = { -1500.0, 6, kOk }
+template<typename T>
+inline ParseResult<T> ParseFloat(std::string_view text)
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>, "ParseFloat expects float or double");
+
+    ParseResult<T> result;
+    const bool negative = !text.empty() && text[0] == '-';
+    std::size_t position = negative ? 1 : 0;
+
+    // Special values are checked only if there is no number, so they don't slow down the usual case
+    if(position < text.size() && static_cast<unsigned char>(text[position] - '0') >= 10 && text[position] != '.')
+    {
+        const std::string_view special = text.substr(position);
+        if(detail::StartsWithIgnoreCase(special, "inf") || detail::StartsWithIgnoreCase(special, "nan"))
+        {
+            const bool isNan = (special[0] | 0x20) == 'n';
+            const T value = isNan ? std::numeric_limits<T>::quiet_NaN() : std::numeric_limits<T>::infinity();
+            result.value = negative ? -value : value;
+            result.length = position + (!isNan && detail::StartsWithIgnoreCase(special, "infinity") ? 8 : 3);
+            result.status = ParseStatus::kOk;
+        }
+        return result;
+    }
+
+    detail::DecimalDigits digits;
+    const std::size_t integerStart = position;
+    position = detail::SkipZeroChars(text, position);
+    position += detail::AppendSignificandDigits(text, position, digits);
+    bool hasDigits = position > integerStart;
+    // Integer digits that didn't fit into significand still scale it
+    int exponent = static_cast<int>(digits.dropped);
+
+    if(position < text.size() && text[position] == '.')
+    {
+        const std::size_t fractionStart = position + 1;
+        std::size_t fractionEnd = fractionStart;
+        if(digits.count == 0)
+        {
+            fractionEnd = detail::SkipZeroChars(text, fractionStart);
+            exponent -= static_cast<int>(fractionEnd - fractionStart);
+        }
+        const DefUIntType droppedBefore = digits.dropped;
+        const std::size_t length = detail::AppendSignificandDigits(text, fractionEnd, digits);
+        exponent -= static_cast<int>(length - (digits.dropped - droppedBefore));
+        fractionEnd += length;
+        hasDigits |= fractionEnd > fractionStart;
+        if(hasDigits)
+            position = fractionEnd;
+    }
+    if(!hasDigits)
+        return result;
+
+    // Exponent is consumed only if it has digits
+    if(position < text.size() && (text[position] | 0x20) == 'e')
+    {
+        std::size_t exponentPosition = position + 1;
+        bool exponentNegative = false;
+        if(exponentPosition < text.size() && (text[exponentPosition] == '-' || text[exponentPosition] == '+'))
+            exponentNegative = text[exponentPosition++] == '-';
+        if(exponentPosition < text.size() && static_cast<unsigned char>(text[exponentPosition] - '0') < 10)
+        {
+            // Anything past 10^5 is already 0 or infinity, so larger exponents are clamped
+            int value = 0;
+            for(; exponentPosition < text.size() && static_cast<unsigned char>(text[exponentPosition] - '0') < 10; exponentPosition++)
+            {
+                if(value < 100000)
+                    value = value * 10 + (text[exponentPosition] - '0');
+            }
+            exponent += exponentNegative ? -value : value;
+            position = exponentPosition;
+        }
+    }
+
+    T value = T(0);
+    if(!detail::DecimalToFloat(digits.significand, exponent, digits.truncated, value))
+        value = detail::ParseFloatFallback(text.substr(integerStart, position - integerStart), T());
+    result.value = negative ? -value : value;
+    result.length = position;
+    result.status = std::isinf(value) ? ParseStatus::kOverflow : ParseStatus::kOk;
+    return result;
+}
+} // Tolik
+
+#endif // TOLIK_MATH_PARSE_HPP
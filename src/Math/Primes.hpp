@@ -0,0 +1,292 @@
+#ifndef TOLIK_MATH_PRIMES_HPP
+#define TOLIK_MATH_PRIMES_HPP
+
+#include <type_traits>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#include "Setup.hpp"
+#include "Math/Utils.hpp"
+#include "Utilities/Type.hpp"
+
+// Deterministic primality test for integers up to 64 bits
+// Divisors below 256 are ruled out first with multiplication by modular inverse, then Miller-Rabin with bases
+// 2, 325, 9375, 28178, 450775, 9780504, 1795265022 (Jim Sinclair's set) decides every number below 2^64.
+// All powers are taken with MontgomeryModulus from Math/Utils.hpp
+
+namespace Tolik
+{
+// Example: IsPrime(97) = true; IsPrime(3215031751u) = false (strong pseudoprime to bases 2, 3, 5 and 7)
+// Negative numbers, 0 and 1 are not prime
+template<typename T>
+constexpr inline bool IsPrime(T number);
+
+// Passes primes from in[0, count) to out in the same order, returns end of output
+// Numbers are tested a chunk at a time: small divisors for the whole chunk, then Miller-Rabin base 2 for numbers left,
+// then the other bases for those that passed it. Powers of several numbers are computed in lockstep,
+// so that their Montgomery multiplications overlap instead of waiting for each other
+template<typename OutputIt>
+inline OutputIt FilterPrimes(const uint64_t *in, std::size_t count, OutputIt out);
+
+#if __cplusplus >= 202002L
+template<typename OutputIt>
+inline OutputIt FilterPrimes(std::span<const uint64_t> in, OutputIt out)
+{ return FilterPrimes(in.data(), in.size(), out); }
+#endif
+
+
+namespace detail
+{
+// n % divisor == 0 exactly when n * inverse <= limit, where inverse = divisor^-1 % 2^64 and limit = (2^64 - 1) / divisor
+// Works for odd divisors only, and needs no division at runtime
+struct DivisibilityTest
+{
+    uint64_t divisor = 1;
+    uint64_t inverse = 1;
+    uint64_t limit = 0;
+};
+
+constexpr inline DivisibilityTest MakeDivisibilityTest(uint64_t divisor)
+{
+    // Newton iteration, same as in MontgomeryModulus
+    uint64_t inverse = divisor;
+    for(int bits = 3; bits < 64; bits *= 2)
+        inverse = inverse * (2 - divisor * inverse);
+    return { divisor, inverse, ~0ull / divisor };
+}
+
+// Odd primes below 256
+constexpr inline std::size_t kSmallOddPrimeCount = 53;
+constexpr inline uint64_t kSmallPrimeBound = 256;
+
+constexpr inline auto MakeSmallPrimeTests() -> std::array<DivisibilityTest, kSmallOddPrimeCount>
+{
+    std::array<DivisibilityTest, kSmallOddPrimeCount> tests{};
+    std::size_t count = 0;
+    for(uint64_t candidate = 3; candidate < kSmallPrimeBound; candidate += 2)
+    {
+        bool prime = true;
+        for(std::size_t i = 0; i < count && prime; i++)
+            prime = candidate % tests[i].divisor != 0;
+        if(prime)
+            tests[count++] = MakeDivisibilityTest(candidate);
+    }
+    return tests;
+}
+
+constexpr inline std::array<DivisibilityTest, kSmallOddPrimeCount> kSmallPrimeTests = MakeSmallPrimeTests();
+static_assert(kSmallPrimeTests.back().divisor == 251, "All odd primes below 256 must be in kSmallPrimeTests");
+
+constexpr inline uint64_t kMillerRabinBases[] = { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+
+enum class SmallPrimeResult : uint8_t
+{
+    kComposite,
+    kPrime,
+    // No divisor below 256, needs Miller-Rabin
+    kUnknown
+};
+
+constexpr inline SmallPrimeResult CheckSmallDivisors(uint64_t number)
+{
+    if(number < 2)
+        return SmallPrimeResult::kComposite;
+    if(number % 2 == 0)
+        return number == 2 ? SmallPrimeResult::kPrime : SmallPrimeResult::kComposite;
+    for(const DivisibilityTest &test : kSmallPrimeTests)
+    {
+        if(number * test.inverse <= test.limit)
+            return number == test.divisor ? SmallPrimeResult::kPrime : SmallPrimeResult::kComposite;
+    }
+    // 257 is the next prime, so composite number would have a divisor below 256
+    return number < 257 * 257 ? SmallPrimeResult::kPrime : SmallPrimeResult::kUnknown;
+}
+
+// Odd number > 2 prepared for Miller-Rabin: number - 1 = oddPart * 2^twos
+struct MillerRabinCandidate
+{
+    constexpr explicit MillerRabinCandidate(uint64_t number, uint32_t newIndex = 0) :
+        modulus(number), one(modulus.ToMontgomery(1)), oddPart((number - 1) >> __builtin_ctzll(number - 1)),
+        twos(__builtin_ctzll(number - 1)), index(newIndex) {}
+
+    MontgomeryModulus<uint64_t> modulus;
+    // 1 in Montgomery form
+    uint64_t one = 0;
+    uint64_t oddPart = 0;
+    int twos = 0;
+    // Position in chunk of FilterPrimes
+    uint32_t index = 0;
+
+    // number - 1 in Montgomery form
+    constexpr uint64_t GetMinusOne() const { return modulus.GetModulus() - one; }
+};
+
+// Squarings after base^oddPart, x is in Montgomery form
+constexpr inline bool FinishStrongProbablePrime(const MillerRabinCandidate &candidate, uint64_t x)
+{
+    const uint64_t minusOne = candidate.GetMinusOne();
+    if(x == candidate.one || x == minusOne)
+        return true;
+    for(int i = 1; i < candidate.twos; i++)
+    {
+        x = candidate.modulus.Multiply(x, x);
+        if(x == minusOne)
+            return true;
+        if(x == candidate.one)
+            return false;
+    }
+    return false;
+}
+
+// Numbers tested in lockstep by KeepStrongProbablePrimes
+constexpr inline std::size_t kPrimeLanes = 4;
+constexpr inline std::size_t kPrimeChunkSize = 256;
+// Exponent bits taken at once by IsStrongProbablePrimeLanes
+constexpr inline int kPrimeWindowBits = 4;
+
+// passed[i] = candidates[i] is strong probable prime to base, for kLanes candidates
+// Every lane goes through windows of the longest exponent and multiplies by base^window from its own table,
+// so there are no unpredictable branches and independent multiplications of lanes are next to each other
+template<std::size_t kLanes>
+constexpr void IsStrongProbablePrimeLanes(const MillerRabinCandidate *candidates, uint64_t base, bool *passed)
+{
+    constexpr uint64_t kWindowMask = (1 << kPrimeWindowBits) - 1;
+    uint64_t powers[kLanes][kWindowMask + 1] = {};
+    uint64_t x[kLanes] = {};
+    uint64_t maxOddPart = 0;
+    for(std::size_t lane = 0; lane < kLanes; lane++)
+    {
+        powers[lane][0] = candidates[lane].one;
+        powers[lane][1] = candidates[lane].modulus.ToMontgomery(base);
+        maxOddPart |= candidates[lane].oddPart;
+    }
+    for(uint64_t i = 2; i <= kWindowMask; i++)
+    {
+        for(std::size_t lane = 0; lane < kLanes; lane++)
+            powers[lane][i] = candidates[lane].modulus.Multiply(powers[lane][i - 1], powers[lane][1]);
+    }
+
+    int shift = static_cast<int>(BitWidth(maxOddPart) - 1) / kPrimeWindowBits * kPrimeWindowBits;
+    for(std::size_t lane = 0; lane < kLanes; lane++)
+        x[lane] = powers[lane][(candidates[lane].oddPart >> shift) & kWindowMask];
+    for(shift -= kPrimeWindowBits; shift >= 0; shift -= kPrimeWindowBits)
+    {
+        for(int i = 0; i < kPrimeWindowBits; i++)
+        {
+#pragma GCC unroll 8
+            for(std::size_t lane = 0; lane < kLanes; lane++)
+                x[lane] = candidates[lane].modulus.Multiply(x[lane], x[lane]);
+        }
+#pragma GCC unroll 8
+        for(std::size_t lane = 0; lane < kLanes; lane++)
+            x[lane] = candidates[lane].modulus.Multiply(x[lane], powers[lane][(candidates[lane].oddPart >> shift) & kWindowMask]);
+    }
+    // Base that is multiple of number says nothing
+    for(std::size_t lane = 0; lane < kLanes; lane++)
+        passed[lane] = powers[lane][1] == 0 || FinishStrongProbablePrime(candidates[lane], x[lane]);
+}
+
+constexpr inline bool IsStrongProbablePrime(const MillerRabinCandidate &candidate, uint64_t base)
+{
+    bool passed = false;
+    IsStrongProbablePrimeLanes<1>(&candidate, base, &passed);
+    return passed;
+}
+
+// Keeps candidates that pass the test to base in the same order, returns their count
+inline std::size_t KeepStrongProbablePrimes(MillerRabinCandidate *candidates, std::size_t count, uint64_t base)
+{
+    std::size_t kept = 0;
+    bool passed[kPrimeLanes] = {};
+    std::size_t i = 0;
+    for(; i + kPrimeLanes <= count; i += kPrimeLanes)
+    {
+        IsStrongProbablePrimeLanes<kPrimeLanes>(candidates + i, base, passed);
+        for(std::size_t lane = 0; lane < kPrimeLanes; lane++)
+        {
+            if(passed[lane])
+                candidates[kept++] = candidates[i + lane];
+        }
+    }
+    for(; i < count; i++)
+    {
+        if(IsStrongProbablePrime(candidates[i], base))
+            candidates[kept++] = candidates[i];
+    }
+    return kept;
+}
+
+// Calls callback(number) for every prime in in[0, count), in the same order
+template<typename Functor>
+void ForEachPrime(const uint64_t *in, std::size_t count, Functor &callback)
+{
+    std::vector<MillerRabinCandidate> candidates;
+    candidates.reserve(kPrimeChunkSize);
+    bool prime[kPrimeChunkSize];
+    for(std::size_t start = 0; start < count; start += kPrimeChunkSize)
+    {
+        const std::size_t size = std::min(kPrimeChunkSize, count - start);
+        candidates.clear();
+        for(std::size_t i = 0; i < size; i++)
+        {
+            const SmallPrimeResult result = CheckSmallDivisors(in[start + i]);
+            prime[i] = result == SmallPrimeResult::kPrime;
+            if(result == SmallPrimeResult::kUnknown)
+                candidates.emplace_back(in[start + i], static_cast<uint32_t>(i));
+        }
+        // Most composites fail the first base, so the other bases run mostly on primes
+        std::size_t left = candidates.size();
+        for(uint64_t base : kMillerRabinBases)
+            left = KeepStrongProbablePrimes(candidates.data(), left, base);
+        for(std::size_t i = 0; i < left; i++)
+            prime[candidates[i].index] = true;
+
+        for(std::size_t i = 0; i < size; i++)
+        {
+            if(prime[i])
+                callback(in[start + i]);
+        }
+    }
+}
+} // detail
+
+
+template<typename T>
+constexpr bool IsPrime(T number)
+{
+    static_assert(std::is_integral_v<T> && sizeof(T) <= 8, "IsPrime expects integer of at most 64 bits");
+    static_assert(detail::kHasModularPower<uint64_t>, "IsPrime needs 128-bit integers for 64-bit Montgomery multiplication");
+    if constexpr(std::is_signed_v<T>)
+    {
+        if(number < 0)
+            return false;
+    }
+    const detail::SmallPrimeResult result = detail::CheckSmallDivisors(static_cast<uint64_t>(number));
+    if(result != detail::SmallPrimeResult::kUnknown)
+        return result == detail::SmallPrimeResult::kPrime;
+
+    const detail::MillerRabinCandidate candidate(static_cast<uint64_t>(number));
+    for(uint64_t base : detail::kMillerRabinBases)
+    {
+        if(!detail::IsStrongProbablePrime(candidate, base))
+            return false;
+    }
+    return true;
+}
+
+template<typename OutputIt>
+OutputIt FilterPrimes(const uint64_t *in, std::size_t count, OutputIt out)
+{
+    auto write = [&](uint64_t number) { *out++ = number; };
+    detail::ForEachPrime(in, count, write);
+    return out;
+}
+} // Tolik
+
+#endif // TOLIK_MATH_PRIMES_HPP
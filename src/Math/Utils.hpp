@@ -1,8 +1,16 @@
 #ifndef TOLIK_MATH_UTILS_HPP
 #define TOLIK_MATH_UTILS_HPP
 
+#include <cassert>
 #include <type_traits>
 #include <cmath>
+#include <array>
+#include <limits>
+#include <utility>
+#include <cstddef>
+#if __cplusplus >= 202002L
+#include <bit>
+#endif
 
 #include "gcem.hpp"
 
@@ -34,96 +42,355 @@ constexpr inline bool AreSame(T t, U u)
 template<typename T>
 constexpr inline static int kMaxDigits = std::numeric_limits<T>::digits10 + 1;
 
+#ifdef TOLIK_HAS_INT128
+// std::numeric_limits isn't always specialized for 128-bit integers
+template<>
+constexpr inline int kMaxDigits<Int128> = 39;
+template<>
+constexpr inline int kMaxDigits<UInt128> = 39;
+#endif
+
+
+// Specialize as std::true_type for types with cheap operator*, or as std::false_type for arithmetic-like types
+// If true, IntegralPower with integer exponent uses sliding window exponentiation, that needs fewer multiplications
+// than binary one, but keeps a few precomputed powers. Every non-arithmetic type (matrix, big integer) is assumed expensive
+template<typename T>
+struct HasExpensiveMultiply : std::bool_constant<!std::is_arithmetic_v<T>>
+{};
+
+template<typename T>
+constexpr inline bool kHasExpensiveMultiply = HasExpensiveMultiply<T>::value;
+
 
 namespace detail
 {
 // https://en.wikipedia.org/wiki/Exponentiation_by_squaring
 
 // Using looping approach because recursion is often slow
+// Every multiplication goes through CountedMultiply, so that IntegralPower can report their count
+
+template<typename T>
+constexpr inline T CountedMultiply(const T &a, const T &b, std::size_t *multiplyCount)
+{
+    if(multiplyCount != nullptr)
+        ++*multiplyCount;
+    return a * b;
+}
+
+// Exponent types without '%' get the low bit as exp - exp / 2 * 2
+template<typename U>
+constexpr inline bool IsOddExponent(const U &exp)
+{
+    if constexpr(kHasModulOperator<U, U>)
+        return !(exp % U(2) == U(0));
+    else
+        return !(exp - (exp / U(2)) * U(2) == U(0));
+}
 
 template<typename T, typename U>
-constexpr inline T IntegralPowerImplUHasNoModulo(const T base, U exp)
+constexpr inline T IntegralPowerImplUHasModulo(T base, U exp, std::size_t *multiplyCount)
 {
     T result = base;
+    base = T(1);
 
     while(U(2) < exp || exp == U(2))
     {
-        result = result * base;
-        exp = exp - 1;
+        if(!IsOddExponent(exp))
+        {
+            result = CountedMultiply(result, result, multiplyCount);
+            exp = exp / U(2);
+            continue;
+        }
+
+        base = CountedMultiply(base, result, multiplyCount);
+        result = CountedMultiply(result, result, multiplyCount);
+        exp = (exp - U(1)) / U(2);
     }
 
-    return result;
+    return CountedMultiply(result, base, multiplyCount);
 }
 
 template<typename T, typename U>
-constexpr inline T IntegralPowerImplUHasModulo(T base, U exp)
+constexpr inline T IntegralPowerImplUHasNoModulo(const T base, U exp, std::size_t *multiplyCount)
 {
+    // Exponent that can be halved is still powered by squaring, see IsOddExponent
+    if constexpr(kHasDivideOperator<U, U>)
+        return IntegralPowerImplUHasModulo(base, exp, multiplyCount);
+
     T result = base;
-    base = T(1);
 
     while(U(2) < exp || exp == U(2))
     {
-        if(exp % U(2) == U(0))
+        result = CountedMultiply(result, base, multiplyCount);
+        exp = exp - 1;
+    }
+
+    return result;
+}
+
+// Largest window of sliding window exponentiation, 2^(kMaxPowerWindow - 1) odd powers are kept
+constexpr inline int kMaxPowerWindow = 4;
+
+template<typename T, std::size_t... I>
+constexpr inline std::array<T, sizeof...(I)> MakeFilledArray(const T &value, std::index_sequence<I...>)
+{ return { { (static_cast<void>(I), value)... } }; }
+
+// Sliding window exponentiation, exp must not be 0
+// Odd powers base^1, base^3 .. base^(2^k - 1) are precomputed, then exponent is scanned from the top bit
+// and every window of at most k bits, that starts and ends with 1, costs one multiplication instead of one per set bit
+// Example: random 64-bit exponent takes about 61 squarings + 20 other multiplications, binary exponentiation needs 63 + 32
+// Only copy constructor and '=' '*' are needed from T
+template<typename T>
+constexpr inline T IntegralPowerImplWindowed(const T &base, uint64_t exp, std::size_t *multiplyCount)
+{
+    const int bitCount = 64 - __builtin_clzll(exp);
+    // Window size that minimizes count of precomputed powers plus count of windows
+    int window = 1;
+    for(int size = 2; size <= kMaxPowerWindow; size++)
+    {
+        if((1 << (size - 1)) + bitCount / (size + 1) < (1 << (window - 1)) + bitCount / (window + 1))
+            window = size;
+    }
+
+    std::array<T, (1 << (kMaxPowerWindow - 1))> oddPowers = MakeFilledArray(base, std::make_index_sequence<(1 << (kMaxPowerWindow - 1))>());
+    if(window > 1)
+    {
+        const T square = CountedMultiply(base, base, multiplyCount);
+        for(int i = 1; i < (1 << (window - 1)); i++)
+            oddPowers[i] = CountedMultiply(oddPowers[i - 1], square, multiplyCount);
+    }
+
+    T result = base;
+    bool started = false;
+    int bit = bitCount - 1;
+    while(bit >= 0)
+    {
+        // Top bit is always 1, so result is started before the first zero
+        if(((exp >> bit) & 1) == 0)
         {
-            result = result * result;
-            exp = exp / 2;
+            result = CountedMultiply(result, result, multiplyCount);
+            bit--;
             continue;
         }
 
-        base = base * result;
-        result = result * result;
-        exp = (exp - U(1)) / U(2);
+        int low = bit - window + 1 < 0 ? 0 : bit - window + 1;
+        while(((exp >> low) & 1) == 0)
+            low++;
+        const int length = bit - low + 1;
+        const uint64_t value = (exp >> low) & ((uint64_t(2) << (length - 1)) - 1);
+        if(started)
+        {
+            for(int i = 0; i < length; i++)
+                result = CountedMultiply(result, result, multiplyCount);
+            result = CountedMultiply(result, oddPowers[value >> 1], multiplyCount);
+        }
+        else
+        {
+            result = oddPowers[value >> 1];
+            started = true;
+        }
+        bit = low - 1;
     }
+    return result;
+}
 
-    return result * base;
+// Positive exponent of integer type U
+template<typename T, typename U>
+constexpr inline T IntegralPowerImplPositive(const T base, const U exp, std::size_t *multiplyCount)
+{
+    if constexpr(kHasExpensiveMultiply<T> && std::is_integral_v<U> && sizeof(U) <= sizeof(uint64_t))
+        return IntegralPowerImplWindowed(base, static_cast<uint64_t>(exp), multiplyCount);
+    else
+        return IntegralPowerImplUHasModulo(base, exp, multiplyCount);
 }
 
 template<typename T, typename U, std::enable_if_t<std::is_arithmetic_v<T> && std::is_arithmetic_v<U>, bool> = true>
-constexpr inline T IntegralPowerImpl(const T base, const U exp) { return gcem::pow(base, exp); }
+constexpr inline T IntegralPowerImpl(const T base, const U exp, std::size_t *) { return gcem::pow(base, exp); }
 
-template<typename T, typename U, std::enable_if_t<!std::is_arithmetic_v<U> && !kHasModulOperator<U>, bool> = true>
-constexpr inline T IntegralPowerImpl(const T base, const U exp)
+template<typename T, typename U, std::enable_if_t<!std::is_arithmetic_v<U> && !kHasModulOperator<U, U>, bool> = true>
+constexpr inline T IntegralPowerImpl(const T base, const U exp, std::size_t *multiplyCount)
 {
     // Special type might be signed
     if(exp == U(0))
         return 1;
-    if(exp < U(0))
-        return T(1) / IntegralPowerImplUHasNoModulo(base, -exp);
+    // Types without '/' (like matrices) can't have negative exponent
+    if constexpr(kHasDivideOperator<T, T>)
+    {
+        if(exp < U(0))
+            return T(1) / IntegralPowerImplUHasNoModulo(base, -exp, multiplyCount);
+    }
+    else
+        assert(!(exp < U(0)) && "Type without '/' can't be raised to negative exponent");
     
-    return IntegralPowerImplUHasNoModulo(base, exp);
+    return IntegralPowerImplUHasNoModulo(base, exp, multiplyCount);
 }
 
-template<typename T, typename U, std::enable_if_t<(std::is_arithmetic_v<U> || kHasModulOperator<U>) && !std::is_signed_v<U>, bool> = true>
-constexpr inline T IntegralPowerImpl(const T base, const U exp)
+template<typename T, typename U, std::enable_if_t<!(std::is_arithmetic_v<T> && std::is_arithmetic_v<U>) && (std::is_arithmetic_v<U> || kHasModulOperator<U, U>) && !std::is_signed_v<U>, bool> = true>
+constexpr inline T IntegralPowerImpl(const T base, const U exp, std::size_t *multiplyCount)
 {
     // Special type might be signed
     if(exp == U(0))
         return 1;
     
-    return IntegralPowerImplUHasModulo(base, exp);
+    return IntegralPowerImplPositive(base, exp, multiplyCount);
 }
 
-template<typename T, typename U, std::enable_if_t<(std::is_arithmetic_v<U> || kHasModulOperator<U>) && std::is_signed_v<U>, bool> = true>
-constexpr inline T IntegralPowerImpl(const T base, const U exp)
+template<typename T, typename U, std::enable_if_t<!(std::is_arithmetic_v<T> && std::is_arithmetic_v<U>) && (std::is_arithmetic_v<U> || kHasModulOperator<U, U>) && std::is_signed_v<U>, bool> = true>
+constexpr inline T IntegralPowerImpl(const T base, const U exp, std::size_t *multiplyCount)
 {
     // Special type might be signed
     if(exp == 0)
         return 1;
     // static cast in case for float for example
-    if(exp < 0)
-        return T(1) / IntegralPowerImplUHasModulo(base, static_cast<uint64_t>(-exp));
+    // Types without '/' (like matrices) can't have negative exponent
+    if constexpr(kHasDivideOperator<T, T>)
+    {
+        if(exp < 0)
+            return T(1) / IntegralPowerImplPositive(base, static_cast<uint64_t>(-exp), multiplyCount);
+    }
+    else
+        assert(exp >= 0 && "Type without '/' can't be raised to negative exponent");
     
-    return IntegralPowerImplUHasModulo(base, exp);
+    return IntegralPowerImplPositive(base, exp, multiplyCount);
 }
 } // detail
 
 // Function to power non-arithemtic type to exponent of non-arithmetic type.
 // If it's normal types std::pow is used.
 // In other case, power algorithm is used, that uses only operators '=' '*' '/' '== '<'
+// For types with expensive multiplication (see HasExpensiveMultiply) and integer exponent sliding window is used
 template<typename T, typename U>
 constexpr inline T IntegralPower(const T base, const U exp)
 {
-    return detail::IntegralPowerImpl(base, exp);
+    return detail::IntegralPowerImpl(base, exp, nullptr);
+}
+
+// Same as IntegralPower(base, exp), and adds count of operator* calls on T to multiplyCount
+// If both types are arithmetic, gcem::pow is used and nothing is counted
+// Example: std::size_t count = 0; IntegralPower(matrix, 1000, count); count == 13;
+template<typename T, typename U>
+constexpr inline T IntegralPower(const T base, const U exp, std::size_t &multiplyCount)
+{
+    return detail::IntegralPowerImpl(base, exp, &multiplyCount);
+}
+
+
+namespace detail
+{
+// Unsigned type twice as wide as T, so that product of two values of T never overflows
+#ifdef TOLIK_HAS_INT128
+template<typename T>
+using ModularWideTypeT = std::conditional_t<sizeof(T) <= 4, uint64_t, UInt128>;
+#else
+template<typename T>
+using ModularWideTypeT = uint64_t;
+#endif
+
+template<typename T>
+constexpr inline bool kHasModularPower = std::is_unsigned_v<T> && std::is_integral_v<T> && (sizeof(T) <= 4
+#ifdef TOLIK_HAS_INT128
+    || sizeof(T) == 8
+#endif
+);
+
+// a * b % modulus for a, b < modulus
+template<typename T>
+constexpr inline T MultiplyModulo(T a, T b, T modulus)
+{ return static_cast<T>(static_cast<ModularWideTypeT<T>>(a) * b % modulus); }
+} // detail
+
+// base^exp % modulus for unsigned integers up to 64 bits
+// Products are done in twice as wide type, so nothing overflows for any modulus, but every step costs a division
+// (128-bit one for 64-bit modulus). If many powers are taken with the same odd modulus, MontgomeryModulus is faster
+// modulus must not be 0 and exp must not be negative
+// Example: ModularPower(2u, 10, 1000u) = 24;
+template<typename T, typename U>
+constexpr inline T ModularPower(T base, U exp, T modulus)
+{
+    static_assert(detail::kHasModularPower<T>, "ModularPower expects unsigned integer of at most 64 bits");
+    static_assert(std::is_integral_v<U>, "ModularPower expects integer exponent");
+    // Arithmetic shift of negative exponent never reaches 0
+    if constexpr(std::is_signed_v<U>)
+        assert(exp >= 0 && "ModularPower can't take negative exponent");
+    T result = T(1) % modulus;
+    base = base % modulus;
+    while(exp != U(0))
+    {
+        if(exp & U(1))
+            result = detail::MultiplyModulo(result, base, modulus);
+        base = detail::MultiplyModulo(base, base, modulus);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// Odd modulus prepared for Montgomery multiplication: values are kept as x * 2^w % modulus (w is bit width of T),
+// so that product is reduced with two multiplications and a shift instead of division
+// Preparation costs one wide division, so it pays off for repeated powers with the same modulus (like Miller-Rabin bases)
+// Example: constexpr MontgomeryModulus<uint64_t> modulus(1000000007); ModularPower(uint64_t(2), 10, modulus) = 1024;
+template<typename T>
+class MontgomeryModulus
+{
+public:
+    static_assert(detail::kHasModularPower<T> && sizeof(T) >= 4, "MontgomeryModulus expects 32 or 64-bit unsigned integer");
+    using WideType = detail::ModularWideTypeT<T>;
+    static constexpr inline int kBits = sizeof(T) * 8;
+
+    // modulus must be odd
+    constexpr explicit MontgomeryModulus(T modulus) : m_modulus(modulus)
+    {
+        // Newton iteration doubles count of correct low bits, and modulus is its own inverse modulo 8
+        m_inverse = modulus;
+        for(int bits = 3; bits < kBits; bits *= 2)
+            m_inverse = m_inverse * (T(2) - modulus * m_inverse);
+        // 2^w % modulus, computed in T as (2^w - modulus) % modulus
+        const T r = static_cast<T>(T(0) - modulus) % modulus;
+        m_rSquared = detail::MultiplyModulo(r, r, modulus);
+    }
+
+    constexpr T GetModulus() const { return m_modulus; }
+
+    // value * 2^-w % modulus for value < modulus * 2^w
+    constexpr T Reduce(WideType value) const
+    {
+        // Low halves of value and q * modulus are equal, so only high halves are subtracted
+        const T q = static_cast<T>(value) * m_inverse;
+        const T high = static_cast<T>(value >> kBits);
+        const T subtracted = static_cast<T>((static_cast<WideType>(q) * m_modulus) >> kBits);
+        return high < subtracted ? high - subtracted + m_modulus : high - subtracted;
+    }
+
+    constexpr T ToMontgomery(T value) const { return Reduce(static_cast<WideType>(value % m_modulus) * m_rSquared); }
+    constexpr T FromMontgomery(T value) const { return Reduce(value); }
+    // Both values and result are in Montgomery form
+    constexpr T Multiply(T a, T b) const { return Reduce(static_cast<WideType>(a) * b); }
+
+private:
+    T m_modulus = 1;
+    // modulus^-1 % 2^w
+    T m_inverse = 1;
+    // 2^2w % modulus, multiplying by it moves value into Montgomery form
+    T m_rSquared = 0;
+};
+
+// Same as ModularPower(base, exp, modulus.GetModulus()), but every step is Montgomery multiplication
+template<typename T, typename U>
+constexpr inline T ModularPower(T base, U exp, const MontgomeryModulus<T> &modulus)
+{
+    static_assert(std::is_integral_v<U>, "ModularPower expects integer exponent");
+    // Arithmetic shift of negative exponent never reaches 0
+    if constexpr(std::is_signed_v<U>)
+        assert(exp >= 0 && "ModularPower can't take negative exponent");
+    T result = modulus.ToMontgomery(T(1));
+    base = modulus.ToMontgomery(base);
+    while(exp != U(0))
+    {
+        if(exp & U(1))
+            result = modulus.Multiply(result, base);
+        base = modulus.Multiply(base, base);
+        exp >>= 1;
+    }
+    return modulus.FromMontgomery(result);
 }
 
 
@@ -148,6 +415,11 @@ constexpr inline DefFloatType kFastPower10NegativeLookup[] =
     static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 12), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 13), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 14), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 15),
     static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 16), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 17), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 18), static_cast<DefFloatType>(1) / gcem::pow<uint64_t, uint64_t>(10, 19)
 };
+
+// Custom integer types can specialize it with kTable, where kTable[i] = 10^i for every 10^i that fits into T
+// FastPower10 then reads kTable instead of multiplying, see BigUInt
+template<typename T>
+struct Power10Lookup : std::false_type {};
 } // detail
 
 // Function to get power of 10 with lookup
@@ -158,76 +430,50 @@ constexpr inline T FastPower10(U exp)
 {
     if constexpr(!std::is_integral_v<U>)
         return gcem::pow(T(10), exp);
-    if constexpr(!std::is_arithmetic_v<T>)
-        return IntegralPower(T(10), exp);
-    else if(std::is_signed_v<U>)
+    else if constexpr(detail::Power10Lookup<T>::value)
     {
-        if(19 < exo || exp < -19)
-            return IntegralPower(T(10), exp);
-        else if(exp < 0)
-            return detail::kFastPower10NegativeLookup[-exp];
-        return detail::kFastPower10PositiveLookup<T>[exp];
+        // Power that doesn't fit and negative power of integer are 0
+        const auto &table = detail::Power10Lookup<T>::kTable;
+        if constexpr(std::is_signed_v<U>)
+        {
+            if(exp < 0)
+                return T(0);
+        }
+        if(static_cast<std::size_t>(exp) >= std::size(table))
+            return T(0);
+        return table[static_cast<std::size_t>(exp)];
     }
-
-    if(U(19) < exp)
+    // Lookup tables are built only for arithmetic types, custom ones would not be constructible from them
+    else if constexpr(!std::is_arithmetic_v<T>)
         return IntegralPower(T(10), exp);
     else
-        return detail::kFastPower10PositiveLookup<T>[exp];
-}
-
-
-// Gets digit at index from number
-// If index is invalid 0 returned
-// If value is floating point, fraction part is ignored, by casting value to long long
-// Indexing starts at 0 and equals the same as (x / 10^index) % 10
-template<typename T = uint8_t, typename U, typename V, std::enable_if_t<!std::is_floating_point_v<U>, bool> = true>
-constexpr inline T GetDigit(U u, V index)
-{
-    // We might get division by 0 if we skip this line
-    if(index < 0)
-        return 0;
-    return (u / FastPower10(index)) % U(10);
-}
-
-template<typename T = uint8_t, typename U, typename V, std::enable_if_t<std::is_floating_point_v<U>, bool> = true>
-constexpr inline T GetDigit(U u, V index)
-{
-    return GetDigit(static_cast<long long>(u), index);
-}
-
-
-// Get substring from number
-// Same as (number / 10^first) % 10^last
-// first number inclusive, last exclusive
-// Example: first = 1, last = 5, number = 6543210 => 4321;
-//          first = 4, last = 8, number = -6543210 => 654;
-//          first = -10, last = 5, number = -6543210 => 43210;
-// If number is floating point, fraction part is ignored by casting value to long long
-template<typename T, typename U, std::enable_if_t<!std::is_floating_point_v<T>, bool> = true>
-constexpr inline T GetDigitSubstring(T number, U first, U last)
-{
-    // I am not  sure about this line.
-    // It might be better to throw an error, but it means we need to check for it anyway, so I would prefer doing it this way
-    // If we'll ignore the fact of negative numbers we'll get SIGFPE that is hard to debug
-    if(first < 0)
-        first = 0;
-    if(last < 0)
-        return 0;
-    if(first >= last)
-        return 0;
-
-    return (number / IntegralPower(10, first)) % IntegralPower(10, last - first);
-}
+    {
+        // Power that doesn't fit into integer is 0 instead of overflowed value
+        if constexpr(kIsInteger<T>)
+        {
+            if(U(kMaxDigits<T>) <= exp)
+                return T(0);
+        }
+        if(std::is_signed_v<U>)
+        {
+            if(19 < exp || exp < -19)
+                return IntegralPower(T(10), exp);
+            else if(exp < 0)
+                return detail::kFastPower10NegativeLookup[-exp];
+            return detail::kFastPower10PositiveLookup<T>[exp];
+        }
 
-template<typename T, typename U, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
-constexpr inline T GetDigitSubstring(T number, U first, U last)
-{
-    return GetDigitSubstring(static_cast<long long>(number), first, last);
+        if(U(19) < exp)
+            return IntegralPower(T(10), exp);
+        else
+            return detail::kFastPower10PositiveLookup<T>[exp];
+    }
 }
 
 
 namespace detail
 {
+// Used for custom types, that can only be divided
 template <typename T>
 constexpr inline DefUIntType DigitCountImpl(T t)
 {
@@ -242,291 +488,288 @@ constexpr inline DefUIntType DigitCountImpl(T t)
     return digits;
 }
 
-template<>
-inline DefUIntType DigitCountImpl<char>(char t)
-{
-    if(t < 0)
-        return DigitCountImpl<char>(-t);
-    
-    static const char x[128] = { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 };
-    return x[static_cast<unsigned char>(t)];
-}
-template<>
-inline DefUIntType DigitCountImpl<unsigned char>(unsigned char t)
+// Absolute value of integer in it's unsigned type
+// Unlike std::abs it doesn't overflow on std::numeric_limits<T>::min()
+template<typename T>
+constexpr inline MakeUnsignedT<T> UnsignedAbs(T t)
 {
-    static const unsigned char x[256] = { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3 };
-    return x[t];
+    using UnsignedT = MakeUnsignedT<T>;
+    if constexpr(kIsSignedInteger<T>)
+        return t < T(0) ? UnsignedT(0) - static_cast<UnsignedT>(t) : static_cast<UnsignedT>(t);
+    else
+        return static_cast<UnsignedT>(t);
 }
 
-template<>
-constexpr inline DefUIntType DigitCountImpl<short>(short t)
+// Number of bits needed to represent (t | 1)
+template<typename T>
+constexpr inline DefUIntType BitWidth(T t)
 {
-    if(t < 0)
-        return DigitCountImpl<short>(-t);
-    
-    if(t >= 100)
+    static_assert(!kIsSignedInteger<T>, "BitWidth expects unsigned value");
+#ifdef TOLIK_HAS_INT128
+    if constexpr(sizeof(T) > sizeof(unsigned long long))
     {
-        if(t >= 1000)
-        {
-            if(t > 10000)
-                return 5;
-            return 4;
-        }
-        return 3;
+        const unsigned long long high = static_cast<unsigned long long>(t >> 64);
+        const unsigned long long low = static_cast<unsigned long long>(t);
+        // Both sides are computed, so compiler is free to use cmov here
+        const DefUIntType highWidth = 128 - __builtin_clzll(high | 1);
+        const DefUIntType lowWidth = 64 - __builtin_clzll(low | 1);
+        return high != 0 ? highWidth : lowWidth;
     }
     else
+#endif
     {
-        if(t >= 10)
-            return 2;
-        return 1;
+#if __cplusplus >= 202002L
+        return std::bit_width(static_cast<unsigned long long>(t) | 1);
+#else
+        return 64 - __builtin_clzll(static_cast<unsigned long long>(t) | 1);
+#endif
     }
 }
-template<>
-constexpr inline DefUIntType DigitCountImpl<unsigned short>(unsigned short t)
+
+// Largest k such that 10^k might have same bit width as value of T, plus one
+// 1233 / 4096 is close enough to log10(2) for every width up to 128 bits
+template<typename T>
+constexpr inline std::size_t kDigitCountPowersSize = ((sizeof(T) * 8 * 1233) >> 12) + 1;
+
+template<typename T>
+constexpr inline std::array<T, kDigitCountPowersSize<T>> MakeDigitCountPowers()
 {
-    if(t >= 100)
+    std::array<T, kDigitCountPowersSize<T>> powers{};
+    T power = T(1);
+    for(std::size_t i = 0; i < powers.size(); i++)
     {
-        if(t >= 1000)
-        {
-            if(t > 10000)
-                return 5;
-            return 4;
-        }
-        return 3;
+        powers[i] = power;
+        power = power * T(10);
     }
+    return powers;
+}
+
+template<typename T>
+constexpr inline std::array<T, kDigitCountPowersSize<T>> kDigitCountPowers = MakeDigitCountPowers<T>();
+
+// Branchless digit count of unsigned integer
+// Bit width gives digit count up to one, and single lookup into power table fixes it
+// 0 = 0 digits, because (0 | 1) has width 1 and 0 < 10^0
+template<typename T>
+constexpr inline DefUIntType DigitCountUnsigned(T t)
+{
+    const DefUIntType approximation = (BitWidth(t) * 1233) >> 12;
+    return approximation + (kDigitCountPowers<T>[approximation] <= t);
+}
+} // detail
+
+// Get number of whole digits in any type
+// 0 = 0 digits
+// For all integer types (including 128-bit) it's branchless and constexpr
+template<typename T = DefUIntType, typename U>
+constexpr inline T DigitCount(U number)
+{
+    if constexpr(kIsInteger<U>)
+        return static_cast<T>(detail::DigitCountUnsigned(detail::UnsignedAbs(number)));
     else
-    {
-        if(t >= 10)
-            return 2;
-        return 1;
-    }
+        return number == U(0) ? T(0) : static_cast<T>(detail::DigitCountImpl(number));
 }
 
-template<>
-constexpr inline DefUIntType DigitCountImpl<int>(int t)
+
+namespace detail
+{
+// Unsigned division by runtime divisor without div instruction
+// Granlund & Montgomery, "Division by Invariant Integers using Multiplication", figure 4.1
+// q = (t + ((n - t) >> shift1)) >> shift2, where t = mulhi(n, multiplier)
+// Works for every divisor including 1, so there is no branch on divisor
+template<typename T>
+struct DivisionMagic
 {
-    if(t < 0) return DigitCountImpl<int>(-t);
+    T multiplier = 0;
+    int shift1 = 0;
+    int shift2 = 0;
+};
 
-    if(t >= 100000)
+// Upper half of full product
+template<typename T>
+constexpr inline T MultiplyHigh(T a, T b)
+{
+    if constexpr(sizeof(T) <= 4)
+        return static_cast<T>((static_cast<uint64_t>(a) * b) >> (sizeof(T) * 8));
+#ifdef TOLIK_HAS_INT128
+    else if constexpr(sizeof(T) <= 8)
+        return static_cast<T>((static_cast<UInt128>(a) * b) >> 64);
+    else
     {
-        if(t >= 10000000)
-        {
-            if(t >= 100000000)
-            {
-                if(t > 1000000000)
-                    return 10;
-                return 9;
-            }
-            return 8;
-        }
-        if(t >= 1000000)
-            return 7;
-        return 6;
+        // Schoolbook multiplication of 64-bit halves
+        const uint64_t aLow = static_cast<uint64_t>(a), aHigh = static_cast<uint64_t>(a >> 64);
+        const uint64_t bLow = static_cast<uint64_t>(b), bHigh = static_cast<uint64_t>(b >> 64);
+        const UInt128 lowLow = static_cast<UInt128>(aLow) * bLow;
+        const UInt128 lowHigh = static_cast<UInt128>(aLow) * bHigh;
+        const UInt128 highLow = static_cast<UInt128>(aHigh) * bLow;
+        const UInt128 highHigh = static_cast<UInt128>(aHigh) * bHigh;
+        const UInt128 middle = (lowLow >> 64) + static_cast<uint64_t>(lowHigh) + static_cast<uint64_t>(highLow);
+        return highHigh + (lowHigh >> 64) + (highLow >> 64) + (middle >> 64);
     }
-    if(t >= 100)
+#else
+    else
     {
-        if(t >= 1000)
-        {
-            if(t >= 10000)
-                return 5;
-            return 4;
-        }
-        return 3;
+        const uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+        const uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+        const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow;
+        const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+        return aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
     }
-    if(t >= 10)
-        return 2;
-    return 1;
+#endif
 }
 
-template<>
-constexpr inline DefUIntType DigitCountImpl<unsigned int>(unsigned int t)
+// Only for building tables, divisor must not be 0
+template<typename T>
+constexpr inline DivisionMagic<T> MakeDivisionMagic(T divisor)
 {
-    if(t >= 100000)
-    {
-        if(t >= 10000000)
-        {
-            if(t >= 100000000)
-            {
-                if(t > 1000000000)
-                    return 10;
-                return 9;
-            }
-            return 8;
-        }
-        if(t >= 1000000)
-            return 7;
-        return 6;
-    }
-    if(t >= 100)
+    constexpr int kBits = sizeof(T) * 8;
+    int log = 0;
+    while(log < kBits && (T(1) << log) < divisor)
+        log++;
+
+    // multiplier = 2^kBits * (2^log - divisor) / divisor + 1
+    // (2^log - divisor) < divisor, so quotient fits into T and is computed with long division bit by bit
+    T remainder = log == kBits ? T(0) - divisor : (T(1) << log) - divisor;
+    T quotient = T(0);
+    for(int i = 0; i < kBits; i++)
     {
-        if(t >= 1000)
+        const bool carry = (remainder >> (kBits - 1)) != T(0);
+        remainder = remainder << 1;
+        quotient = quotient << 1;
+        if(carry || divisor <= remainder)
         {
-            if(t >= 10000)
-                return 5;
-            return 4;
+            remainder = remainder - divisor;
+            quotient = quotient | T(1);
         }
-        return 3;
     }
-    if(t >= 10)
-        return 2;
-    return 1;
+
+    DivisionMagic<T> magic;
+    magic.multiplier = quotient + T(1);
+    magic.shift1 = log < 1 ? log : 1;
+    magic.shift2 = log - 1 > 0 ? log - 1 : 0;
+    return magic;
 }
 
-template<>
-constexpr inline DefUIntType DigitCountImpl<long long>(long long t)
+template<typename T>
+constexpr inline T ApplyDivisionMagic(T value, const DivisionMagic<T> &magic)
 {
-    if(t < 0)
-        return DigitCountImpl<long long>(-t);
+    const T high = MultiplyHigh(value, magic.multiplier);
+    return (high + ((value - high) >> magic.shift1)) >> magic.shift2;
+}
 
-    if(t >= 10000000000)
-    {
-        if(t >= 100000000000000)
-        {
-            if(t >= 10000000000000000)
-            {
-                if(t >= 100000000000000000)
-                {
-                    if(t >= 1000000000000000000)
-                        return 19;
-                    return 18;
-                }
-                return 17;
-            }
-            if(t >= 1000000000000000)
-                return 16;
-            return 15;
-        } 
-        if(t >= 1000000000000)
-        {
-            if(t >= 10000000000000)
-                return 14;
-            return 13;
-        }
-        if(t >= 100000000000)
-            return 12;
-        return 11;
-    }
-    if(t >= 100000)
-    {
-        if(t >= 10000000)
-        {
-            if(t >= 100000000)
-            {
-                if(t >= 1000000000)
-                    return 10;
-                return 9;
-            }
-            return 8;
-        }
-        if (t >= 1000000)
-            return 7;
-        return 6;
-    }
-    if(t >= 100)
-    {
-        if(t >= 1000)
-        {
-            if(t >= 10000)
-                return 5;
-            return 4;
-        }
-        return 3;
-    }
-    if(t >= 10)
-        return 2;
-    return 1;
+// Unsigned type that is used for division by power of 10, small types are promoted to 32 bits
+template<typename T>
+using Power10DivisionType = std::conditional_t<sizeof(T) <= 4, uint32_t, MakeUnsignedT<T>>;
+
+template<typename T>
+constexpr inline std::array<DivisionMagic<T>, kDigitCountPowersSize<T>> MakePower10Magic()
+{
+    std::array<DivisionMagic<T>, kDigitCountPowersSize<T>> magic{};
+    for(std::size_t i = 0; i < magic.size(); i++)
+        magic[i] = MakeDivisionMagic(kDigitCountPowers<T>[i]);
+    return magic;
 }
-template<>
-constexpr inline DefUIntType DigitCountImpl<unsigned long long>(unsigned long long t)
+
+// kPower10Magic<T>[i] divides by 10^i for every 10^i that fits into T
+template<typename T>
+constexpr inline std::array<DivisionMagic<T>, kDigitCountPowersSize<T>> kPower10Magic = MakePower10Magic<T>();
+
+// value / 10^exp for unsigned T from Power10DivisionType, exp must be less than kDigitCountPowersSize<T>
+template<typename T>
+constexpr inline T DividePower10Unsigned(T value, std::size_t exp)
+{ return ApplyDivisionMagic(value, kPower10Magic<T>[exp]); }
+} // detail
+
+// Same as number / FastPower10<T>(exp), rounded toward 0
+// For integers (including 128-bit) it's multiply and shift with magic number from table, without div instruction
+// If exp is negative number is returned, if 10^exp is bigger than any value of T 0 is returned
+// Example: DividePower10(-6543210, 3) = -6543;
+template<typename T, typename U>
+constexpr inline T DividePower10(T number, U exp)
 {
-    if(t >= 10000000000)
-    {
-        if(t >= 1000000000000000)
-        {
-            if(t >= 100000000000000000)
-            {
-                if(t >= 1000000000000000000)
-                {
-                    if(t >= 10000000000000000000u)
-                        return 20;
-                    return 19;
-                }
-                return 18;
-            }
-            if(t >= 10000000000000000)
-                return 17;
-            return 16;
-        } 
-        if(t >= 1000000000000)
-        {
-            if(t >= 10000000000000)
-            {
-                if(t > 100000000000000)
-                    return 15;
-                return 14;
-            }
-            return 13;
-        }
-        if(t >= 100000000000)
-            return 12;
-        return 11;
-    }
-    if(t >= 100000)
+    if(exp < U(0))
+        return number;
+    if constexpr(kIsInteger<T>)
     {
-        if(t >= 10000000)
-        {
-            if(t >= 100000000)
-            {
-                if(t >= 1000000000)
-                    return 10;
-                return 9;
-            }
-            return 8;
-        }
-        if (t >= 1000000)
-            return 7;
-        return 6;
+        using UnsignedT = detail::Power10DivisionType<T>;
+        if(U(detail::kDigitCountPowersSize<UnsignedT>) <= exp)
+            return T(0);
+        const UnsignedT quotient = detail::DividePower10Unsigned<UnsignedT>(detail::UnsignedAbs(number), static_cast<std::size_t>(exp));
+        return number < T(0) ? static_cast<T>(UnsignedT(0) - quotient) : static_cast<T>(quotient);
     }
-    if(t >= 100)
+    else
+        return number / FastPower10<T>(exp);
+}
+
+
+// Gets digit at index from number
+// If index is invalid 0 returned
+// If value is floating point, fraction part is ignored, by casting value to long long
+// Indexing starts at 0 and equals the same as (x / 10^index) % 10
+// For integers division goes through DividePower10, so there is no div instruction
+template<typename T = uint8_t, typename U, typename V, std::enable_if_t<!std::is_floating_point_v<U>, bool> = true>
+constexpr inline T GetDigit(U u, V index)
+{
+    // We might get division by 0 if we skip this line
+    if(index < 0)
+        return 0;
+    if constexpr(kIsInteger<U>)
     {
-        if(t >= 1000)
-        {
-            if(t >= 10000)
-                return 5;
-            return 4;
-        }
-        return 3;
+        // % 10 by constant is multiply and shift too
+        const T digit = static_cast<T>(DividePower10(detail::UnsignedAbs(u), index) % 10u);
+        return u < U(0) ? static_cast<T>(T(0) - digit) : digit;
     }
-    if(t >= 10)
-        return 2;
-    return 1;
+    else
+        return static_cast<T>(DividePower10(u, index) % U(10));
 }
-} // detail
 
-// Get number of whole digits in any type
-// 0 = 0 digits
-template<typename T = DefUIntType, typename U>
-constexpr inline T DigitCount(U number)
+template<typename T = uint8_t, typename U, typename V, std::enable_if_t<std::is_floating_point_v<U>, bool> = true>
+constexpr inline T GetDigit(U u, V index)
 {
-    return number == 0 ? 0 : static_cast<T>(detail::DigitCountImpl(number));
+    return GetDigit(static_cast<long long>(u), index);
 }
 
 
-//template<typename T>
-//constexpr inline bool IsMathematicallyIntegral(T t)
-//{
-//    DefFloatType result = gcem::cos(2 * t * GCEM_PI);
-//    return result == 1;
-//}
-//
-//
-//template<typename T = DefUIntType, typename U>
-//constexpr inline T DigitCountAfterPoint(U number)
-//{
-//    T result = T(0);
-//    while(!IsMathematicallyIntegral(number))
-//}
+// Get substring from number
+// Same as (number / 10^first) % 10^last
+// first number inclusive, last exclusive
+// Example: first = 1, last = 5, number = 6543210 => 4321;
+//          first = 4, last = 8, number = -6543210 => 654;
+//          first = -10, last = 5, number = -6543210 => 43210;
+// If number is floating point, fraction part is ignored by casting value to long long
+// For integers both division and modulo go through DividePower10, so there is no div instruction
+template<typename T, typename U, std::enable_if_t<!std::is_floating_point_v<T>, bool> = true>
+constexpr inline T GetDigitSubstring(T number, U first, U last)
+{
+    // I am not  sure about this line.
+    // It might be better to throw an error, but it means we need to check for it anyway, so I would prefer doing it this way
+    // If we'll ignore the fact of negative numbers we'll get SIGFPE that is hard to debug
+    if(first < 0)
+        first = 0;
+    if(last < 0)
+        return 0;
+    if(first >= last)
+        return 0;
+
+    if constexpr(kIsInteger<T>)
+    {
+        using UnsignedT = detail::Power10DivisionType<T>;
+        const UnsignedT shifted = DividePower10(static_cast<UnsignedT>(detail::UnsignedAbs(number)), first);
+        // Modulo by 10^k that doesn't fit into T keeps value as is
+        const U length = last - first;
+        const UnsignedT result = U(detail::kDigitCountPowersSize<UnsignedT>) <= length ? shifted :
+            shifted - DividePower10(shifted, length) * detail::kDigitCountPowers<UnsignedT>[static_cast<std::size_t>(length)];
+        return number < T(0) ? static_cast<T>(UnsignedT(0) - result) : static_cast<T>(result);
+    }
+    else
+        return (number / IntegralPower(T(10), first)) % IntegralPower(T(10), last - first);
+}
 
+template<typename T, typename U, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
+constexpr inline T GetDigitSubstring(T number, U first, U last)
+{
+    return GetDigitSubstring(static_cast<long long>(number), first, last);
+}
 } // Tolik
 
 
@@ -5,4 +5,14 @@
 
 #define TOLIK_BIT(x) (1 << (x))
 
+// __extension__ keeps -pedantic-errors from rejecting 128-bit integers
+#ifdef __SIZEOF_INT128__
+#define TOLIK_HAS_INT128
+namespace Tolik
+{
+__extension__ typedef __int128 Int128;
+__extension__ typedef unsigned __int128 UInt128;
+} // Tolik
+#endif
+
 #endif // TOLIK_SETUP_HPP
\ No newline at end of file
@@ -0,0 +1,48 @@
+#include "Utilities/Cpu.hpp"
+
+#include <atomic>
+#include <algorithm>
+
+#include "Setup.hpp"
+
+namespace Tolik
+{
+namespace
+{
+SimdLevel DetectSimdLevel()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512cd") && __builtin_cpu_supports("avx512bw"))
+		return SimdLevel::kAVX512;
+	if(__builtin_cpu_supports("avx2"))
+		return SimdLevel::kAVX2;
+	if(__builtin_cpu_supports("sse4.2"))
+		return SimdLevel::kSSE42;
+#endif
+	return SimdLevel::kScalar;
+}
+
+std::atomic<SimdLevel> &CurrentSimdLevel()
+{
+	static std::atomic<SimdLevel> level(GetSupportedSimdLevel());
+	return level;
+}
+} // namespace
+
+SimdLevel GetSupportedSimdLevel()
+{
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+}
+
+SimdLevel GetSimdLevel()
+{
+	return CurrentSimdLevel().load(std::memory_order_relaxed);
+}
+
+void SetSimdLevel(SimdLevel level)
+{
+	CurrentSimdLevel().store(std::min(level, GetSupportedSimdLevel()), std::memory_order_relaxed);
+}
+} // Tolik
@@ -0,0 +1,29 @@
+#ifndef TOLIK_UTILITIES_CPU_HPP
+#define TOLIK_UTILITIES_CPU_HPP
+
+#include "Setup.hpp"
+
+namespace Tolik
+{
+// Instruction sets used by runtime dispatched kernels, ordered from weakest to strongest
+enum class SimdLevel : uint8_t
+{
+	kScalar = 0,
+	kSSE42,
+	kAVX2,
+	kAVX512
+};
+
+// Best level supported by current cpu, detected only once
+SimdLevel GetSupportedSimdLevel();
+
+// Level that dispatched kernels should use
+// By default equals GetSupportedSimdLevel()
+SimdLevel GetSimdLevel();
+
+// Limit dispatched kernels to level, it's clamped to supported one
+// Useful for testing and benchmarking slower paths
+void SetSimdLevel(SimdLevel level);
+} // Tolik
+
+#endif // TOLIK_UTILITIES_CPU_HPP
@@ -1,7 +1,12 @@
 #ifndef TOLIK_UTILITIES_HASH_HPP
 #define TOLIK_UTILITIES_HASH_HPP
 
+#include <cstdint>
+
 #include "Setup.hpp"
+#include "Math/Utils.hpp"
+#include "Math/Digits.hpp"
+#include "Utilities/Type.hpp"
 
 namespace Tolik
 {
@@ -88,6 +93,108 @@ struct NumberToString : detail::NumberToStringImpl<(Number < 0), (Number < 0 ? -
 
 template<auto Number>
 constexpr char *number_to_string = NumberToString<Number>::value;
+
+
+// Runtime counterpart of NumberToString
+
+// Longest text WriteDecimal can produce for T, including '-'
+template<typename T>
+constexpr inline std::size_t kMaxDecimalLength = kMaxDigits<T> + (kIsSignedInteger<T> ? 1 : 0);
+
+namespace detail
+{
+// "00" "01" ... "99", so that two digits are written with one lookup
+constexpr inline char kDecimalDigitPairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+constexpr inline void WriteDigitPair(char *out, uint32_t pair)
+{
+    out[0] = kDecimalDigitPairs[pair * 2];
+    out[1] = kDecimalDigitPairs[pair * 2 + 1];
+}
+
+// Writes digits of value < 2^32 backwards, so end is known from digit count and nothing is moved after
+constexpr inline void WriteDecimalBackwards(char *end, uint32_t value)
+{
+    while(value >= 100)
+    {
+        end -= 2;
+        WriteDigitPair(end, value % 100);
+        value /= 100;
+    }
+    if(value >= 10)
+        WriteDigitPair(end - 2, value);
+    else
+        end[-1] = static_cast<char>('0' + value);
+}
+
+// Exactly 8 digits of value < 10^8, with leading zeros
+// All 8 digits are split at once in one word (see EightDigitsToWord) and written with one store
+constexpr inline void WriteEightDigits(char *out, uint32_t value)
+{
+    // Most significant digit goes first in text, so bytes are swapped
+    const uint64_t word = __builtin_bswap64(EightDigitsToWord(value)) | 0x3030303030303030ull;
+#pragma GCC unroll 8
+    for(int i = 0; i < 8; i++)
+        out[i] = static_cast<char>(word >> (i * 8));
+}
+} // detail
+
+// Writes value in decimal form starting at out and returns pointer past the last written char
+// Exactly DigitCount(value) chars are written (and '-' for negative values, "0" for 0), no terminating '\0'
+// out must have room for kMaxDecimalLength<T> chars, or for the exact length if it's known
+// Digits are written two at a time from lookup table, values above 2^32 are split in 8 digit blocks,
+// so most of work is done in 32-bit arithmetic
+// Example: char buffer[kMaxDecimalLength<int>]; std::string_view(buffer, WriteDecimal(buffer, -120) - buffer) == "-120"
+template<typename T>
+constexpr inline char *WriteDecimal(char *out, T value)
+{
+    static_assert(kIsInteger<T>, "WriteDecimal expects integer value");
+    auto magnitude = detail::UnsignedAbs(value);
+    if constexpr(kIsSignedInteger<T>)
+    {
+        if(value < T(0))
+            *out++ = '-';
+    }
+
+    const DefUIntType digits = magnitude == 0 ? 1 : DigitCount(magnitude);
+    char *const end = out + digits;
+    if constexpr(sizeof(T) > sizeof(uint32_t))
+    {
+        // Low 8 digits are cut off until the rest fits into 32 bits
+        char *blockEnd = end;
+        while(magnitude > 0xFFFFFFFFu)
+        {
+            const auto high = DividePower10(magnitude, 8);
+            blockEnd -= 8;
+            detail::WriteEightDigits(blockEnd, static_cast<uint32_t>(magnitude - high * 100000000u));
+            magnitude = high;
+        }
+        detail::WriteDecimalBackwards(blockEnd, static_cast<uint32_t>(magnitude));
+    }
+    else
+        detail::WriteDecimalBackwards(end, static_cast<uint32_t>(magnitude));
+    return end;
+}
+
+// "-2.2250738585072014e-308"
+template<>
+constexpr inline std::size_t kMaxDecimalLength<double> = 24;
+// "-1.17549435e-38"
+template<>
+constexpr inline std::size_t kMaxDecimalLength<float> = 15;
+
+// Shortest text that is parsed back to exactly the same value, same as std::to_chars(first, last, value) writes
+// Fixed notation is used unless scientific is shorter: 0.001, 123456, 1e+20, 1.5e-07; also "inf", "nan", "-0"
+// Digits are found by Schubfach algorithm (see ToShortestDecimal in Math/Float.hpp) without big integers or loops
+// out must have room for kMaxDecimalLength<T> chars
+// Defined in Math/Float.cpp
+char *WriteDecimal(char *out, double value);
+char *WriteDecimal(char *out, float value);
 } // Tolik
 
 #endif // TOLIK_UTILITIES_HASH_HPP
\ No newline at end of file
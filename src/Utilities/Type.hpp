@@ -52,7 +52,11 @@ struct FunctorTraitsBase
 {
 	using ReturnType = T;
 	constexpr static inline std::size_t arg_count = sizeof...(Args);
-	using ArgType = std::tuple_element_t<I, std::tuple<Args...>>;
+	template<std::size_t I>
+	struct arg
+	{ using type = std::remove_cv_t<std::remove_reference_t<std::tuple_element_t<I, std::tuple<Args...>>>>; };
+	template<std::size_t I>
+	using ArgT = typename arg<I>::type;
 };
 	
 template<typename T, typename... Args>
@@ -136,6 +140,63 @@ struct HasModulOperator<T, U, MakeVoidT<decltype(std::declval<T>() % std::declva
 
 template<typename T, typename U>
 constexpr inline bool kHasModulOperator = HasModulOperator<T, U>::value;
+
+template<typename T, typename U, typename = void>
+struct HasDivideOperator : std::false_type
+{};
+
+template<typename T, typename U>
+struct HasDivideOperator<T, U, MakeVoidT<decltype(std::declval<T>() / std::declval<U>())>> : std::true_type
+{};
+
+template<typename T, typename U>
+constexpr inline bool kHasDivideOperator = HasDivideOperator<T, U>::value;
+
+
+// std::is_integral and std::make_unsigned don't know about 128-bit integers in strict ISO mode
+template<typename T>
+struct IsInteger : std::bool_constant<std::is_integral_v<T> && !std::is_same_v<std::remove_cv_t<T>, bool>>
+{};
+
+template<typename T>
+struct MakeUnsigned : std::make_unsigned<T>
+{};
+
+#ifdef TOLIK_HAS_INT128
+template<>
+struct IsInteger<Int128> : std::true_type
+{};
+
+template<>
+struct IsInteger<UInt128> : std::true_type
+{};
+
+template<>
+struct MakeUnsigned<Int128>
+{ using type = UInt128; };
+
+template<>
+struct MakeUnsigned<UInt128>
+{ using type = UInt128; };
+#endif
+
+template<typename T>
+constexpr inline bool kIsInteger = IsInteger<T>::value;
+
+template<typename T>
+using MakeUnsignedT = typename MakeUnsigned<T>::type;
+
+// Same as std::is_signed, but also true for 128-bit integers and false for floating-point
+template<typename T, bool = kIsInteger<T>>
+struct IsSignedInteger : std::false_type
+{};
+
+template<typename T>
+struct IsSignedInteger<T, true> : std::bool_constant<(T(-1) < T(0))>
+{};
+
+template<typename T>
+constexpr inline bool kIsSignedInteger = IsSignedInteger<T>::value;
 } // Tolik
 
 #endif // TOLIK_UTILITIES_TYPE_HPP
\ No newline at end of file